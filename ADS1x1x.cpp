@@ -11,57 +11,160 @@ void ADS1x1x::setup(const Address address, const DeviceType device_type,
     setDeviceType(device_type);
     setSettings(settings);
     set(State::WAIT_BEGIN);
-    _latest_request_time = 0;
 }
 
 void ADS1x1x::begin() {
     if (not in(State::WAIT_BEGIN)) { end(); }
-    Wire.begin();
-
-    if (not applyFullScaleRange()) { return; }
-    if (not applyDataRate()) { return; }
-
-    uint16_t config_reg;
-    if (not read(Register::CONFIG_REGISTER, &config_reg)) { return; }
-    setBit(&config_reg, use(CONFIG_REGISTER::CONF_MODE), 1);    // Single-shot
-    if (not write(Register::CONFIG_REGISTER, config_reg)) { return; }
+    if (not _bus_acquired) {
+        if (not _bus->acquire()) {
+            setError(Result::FAILED_NOT_RESPONDING);
+            return;
+        }
+        _bus_acquired = true;
+    }
 
+    _timing.reset(getConversionDelay(_settings.data_rate) * 1000);
+    if (not _rail.isOn()) {
+        _rail.on();
+        delayMicroseconds(POWER_UP_TIME);
+    }
+    const bool done = initialize() == Result::SUCCESS;
+    // The config is cached; each request powers the adc again
+    _rail.off();
+    if (not done) {
+        if (_error == Result::FAILED_NOT_RESPONDING) {
+            // Not plugged in yet; update() or request() looks for it
+            _presence.lost(millis());
+            set(State::ABSENT);
+        }
+        return;
+    }
     set(State::IDLE);
-    _latest_request_time = 0;
 }
 
-void ADS1x1x::update() {
+bool ADS1x1x::update(const uint32_t budget) {
+    const uint32_t started = micros();
+    const State entered = _state;
+    const uint32_t polls = _stats.status_polls;
+    uint32_t before = started;
+    bool work;
+    while (true) {
+        step();
+        const uint32_t now = micros();
+        const uint32_t cost = now - before;
+        // Forget a slow step gradually, e.g. one stretched by an interrupt
+        _step_cost = cost > _step_cost ? cost : _step_cost - (_step_cost - cost) / 16;
+        // Only the result read follows without waiting for the adc
+        work = in(State::COMPLETE);
+        if (not work or budget == 0 or now - started + _step_cost > budget) { break; }
+        before = now;
+    }
+    if (_state != entered or _stats.status_polls != polls) {
+        _update_time.add(micros() - started);
+    }
+    return work;
+}
+
+void ADS1x1x::step() {
     switch (_state) {
     case State::BUSY: {
-        if (millis() - _latest_request_time
-            >= getConversionDelay(_settings.data_rate)) {
+        const uint32_t now = micros();
+        // Leave the bus alone until just before the learned completion time
+        if (not _timing.due(now)) { break; }
+        uint16_t config_reg;
+        if (not read(Register::CONFIG_REGISTER, &config_reg)) {
+            fail();
+            break;
+        }
+        ++_stats.status_polls;
+        ++_request_polls;
+        // OS reads back 1 once the device is no longer converting
+        const bool ready = hasBitSet(config_reg, use(CONFIG_REGISTER::CONF_OS));
+        _timing.observe(now, ready);
+        if (ready) {
             set(State::COMPLETE);
-            _latest_request_time = 0;
+        } else if (static_cast<int32_t>(now - _deadline) >= 0) {
+            ++_stats.timeouts;
+            setError(Result::FAILED_TIMEOUT);
+            fail();
         }
         break;
     }
     case State::COMPLETE: {
         uint16_t conv_reg;
-        if (not read(Register::CONVERSION_REGISTER, &conv_reg)) { set(State::ERROR); }
+        if (not read(Register::CONVERSION_REGISTER, &conv_reg)) {
+            fail();
+            break;
+        }
+        int16_t full_code = 0x7FF;
         switch (_device_type) {
         case DeviceType::ADS101x: {
             // 12bit
-            _values.raw = conv_reg >> 4;
-            _values.voltage = _values.raw * use(_settings.full_scale_range) / 0x7FF;
+            _values.raw = static_cast<int16_t>(conv_reg) >> 4;
             break;
         }
         case DeviceType::ADS111x: {
             // 16bit
-            _values.raw = conv_reg;
-            _values.voltage = _values.raw * use(_settings.full_scale_range) / 0x7FFF;
+            _values.raw = static_cast<int16_t>(conv_reg);
+            full_code = 0x7FFF;
             break;
         }
         default: break;
         }
+        _values.voltage = _values.raw * use(_values.range) / full_code;
+        if (_auto_range) {
+            const uint8_t mux =
+                (_request_config >> use(CONFIG_REGISTER::CONF_MUX0)) & 0x7;
+            const bool saturated = _values.raw >= full_code or _values.raw < -full_code;
+            if (saturated and _values.range != _settings.full_scale_range) {
+                // The level is unknown; convert again at the widest range
+                _levels[mux] = LEVEL_UNKNOWN;
+                _values.range = _settings.full_scale_range;
+                setPattern(&_request_config, use(CONFIG_REGISTER::CONF_PGA0),
+                           pgaOf(_values.range), 3);
+                ++_stats.reconversions;
+                if (not start(_request_config)) { fail(); }
+                break;
+            }
+            const int32_t magnitude = _values.raw < 0 ? -_values.raw : _values.raw;
+            _levels[mux] = magnitude * use(_values.range) / full_code;
+        }
+        ++_stats.samples;
+        _failure = Result::SUCCESS;
+        _presence.hit();
+        _rail.off();
+        _energy.completeSample();
+        _latency.add(micros() - _requested_at);
+        _polls.add(_request_polls);
         set(State::AVAILABLE);
         break;
     }
     case State::ERROR: {
+        _rail.off();
+        set(State::IDLE);
+        if (_error == Result::FAILED_NOT_RESPONDING) {
+            miss();
+        } else {
+            _presence.hit();
+        }
+        break;
+    }
+    case State::ABSENT: {
+        // A switched adc is looked for by request(), which powers it
+        if (_rail.isGated() or not _presence.due(millis())) { break; }
+        // An address-only transaction costs the bus least
+        if (not _bus->probe(use(_address))) {
+            _presence.backoff();
+            break;
+        }
+        // The config register is back at its reset value after power-up
+        if (not initialize()) {
+            _presence.backoff();
+            break;
+        }
+        ++_stats.reattaches;
+        _presence.found();
+        _failure = Result::SUCCESS;
         set(State::IDLE);
         break;
     }
@@ -70,19 +173,79 @@ void ADS1x1x::update() {
 }
 
 void ADS1x1x::end() {
+    _rail.off();
+    if (_bus_acquired) {
+        // Other devices may still use the bus; it stops with its last user
+        _bus->release();
+        _bus_acquired = false;
+    }
     if (in(State::WAIT_BEGIN)) { return; }
-    Wire.end();
     set(State::WAIT_BEGIN);
 }
 
+void ADS1x1x::onSleep() {
+    if (_sleep.asleep) { return; }
+    // Nothing runs before begin(), while absent, or without supply
+    if (in(State::WAIT_SETUP) or in(State::WAIT_BEGIN) or in(State::ABSENT)
+        or not _rail.isOn()) {
+        return;
+    }
+    uint16_t config_reg;
+    if (not read(Register::CONFIG_REGISTER, &config_reg)) { return; }
+    _sleep.asleep = true;
+    _sleep.continuous = not hasBitSet(config_reg, use(CONFIG_REGISTER::CONF_MODE));
+    if (not _sleep.continuous) { return; }
+    setBit(&config_reg, use(CONFIG_REGISTER::CONF_MODE), 1);
+    // Without starting another conversion
+    setBit(&config_reg, use(CONFIG_REGISTER::CONF_OS), 0);
+    write(Register::CONFIG_REGISTER, config_reg);
+}
+
+void ADS1x1x::onWakeup() {
+    if (not _sleep.asleep) { return; }
+    _sleep.asleep = false;
+    uint16_t config_reg;
+    if (not read(Register::CONFIG_REGISTER, &config_reg)) { return; }
+    if (_sleep.continuous) {
+        setBit(&config_reg, use(CONFIG_REGISTER::CONF_MODE), 0);
+        write(Register::CONFIG_REGISTER, config_reg);
+        return;
+    }
+    if (not in(State::BUSY)) { return; }
+    if (hasBitSet(config_reg, use(CONFIG_REGISTER::CONF_OS))) {
+        // The sleep says nothing about the conversion time; do not learn from it
+        set(State::COMPLETE);
+    } else {
+        _deadline = micros() + _timing.getNominal() * 2;
+    }
+}
+
 ADS1x1x::Result ADS1x1x::request(ChannelConfig channel_config) {
-    if (not in(State::IDLE)) {
+    if (in(State::ABSENT)) {
+        // A switched adc is only powered to look for it when a probe is due
+        if (not _rail.isGated() or not _presence.due(millis())) {
+            setError(Result::FAILED_NOT_RESPONDING);
+            return _error;
+        }
+    } else if (not in(State::IDLE)) {
         setError(Result::FAILED_BUSY);
         return _error;
     }
 
+    _failure = Result::SUCCESS;
+    _energy.startSample();
+    _requested_at = micros();
+    _request_polls = 0;
     uint16_t config_reg;
-    if (not read(Register::CONFIG_REGISTER, &config_reg)) { return _error; }
+    if (not _rail.isOn()) {
+        // Powered off, the config is back at its reset value; no need to read it
+        _rail.on();
+        delayMicroseconds(POWER_UP_TIME);
+        config_reg = _config;
+    } else if (not read(Register::CONFIG_REGISTER, &config_reg)) {
+        miss();
+        return _error;
+    }
     setBit(&config_reg, use(CONFIG_REGISTER::CONF_OS), 1);
     switch (channel_config) {
     case ChannelConfig::AIN0_AIN1: {
@@ -119,58 +282,93 @@ ADS1x1x::Result ADS1x1x::request(ChannelConfig channel_config) {
     }
     default: break;
     }
-    if (not write(Register::CONFIG_REGISTER, config_reg)) { return _error; }
-    set(State::BUSY);
-    _latest_request_time = millis();
+    // The range goes out with the write that starts the conversion
+    const uint8_t mux = (config_reg >> use(CONFIG_REGISTER::CONF_MUX0)) & 0x7;
+    _values.range = _auto_range ? pickRange(mux) : _settings.full_scale_range;
+    setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), pgaOf(_values.range), 3);
+    if (not start(config_reg)) {
+        miss();
+        return _error;
+    }
+    if (_presence.isAbsent()) {
+        ++_stats.reattaches;
+        _presence.found();
+    }
     return ADS1x1x::Result::SUCCESS;
 }
 
 ADS1x1x::Result ADS1x1x::read(uint16_t* const voltage) {
-    if (not in(State::AVAILABLE)) {
-        setError(Result::FAILED_BUSY);
-        return _error;
-    }
+    if (not in(State::AVAILABLE)) { return failRead(); }
+    *voltage = _values.voltage;
+    set(State::IDLE);
+    return Result::SUCCESS;
+}
+
+ADS1x1x::Result ADS1x1x::read(uint16_t* const voltage, int16_t* const raw) {
+    if (not in(State::AVAILABLE)) { return failRead(); }
     *voltage = _values.voltage;
+    *raw = _values.raw;
     set(State::IDLE);
     return Result::SUCCESS;
 }
 
+ADS1x1x::Stats ADS1x1x::getStats() const {
+    Stats stats = _stats;
+    stats.conversion_time = _timing.getLearned();
+    stats.conversion_ratio = _timing.getRatio();
+    stats.rail_on_time = _rail.getTotalOnTime();
+    stats.rail_on_time_last = _rail.getLastOnTime();
+    stats.energy_total = _energy.getTotal();
+    stats.energy_last = _energy.getLast();
+    return stats;
+}
+
 // MARK: Specific utils (private)
 
-ADS1x1x::Result ADS1x1x::applyFullScaleRange() {
+ADS1x1x::Result ADS1x1x::initialize() {
+    if (not applyFullScaleRange()) { return _error; }
+    if (not applyDataRate()) { return _error; }
+
     uint16_t config_reg;
     if (not read(Register::CONFIG_REGISTER, &config_reg)) { return _error; }
-    switch (_settings.full_scale_range) {
-    case FullScaleRange::FSR_6144mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b000, 3);
-        break;
-    }
-    case FullScaleRange::FSR_4096mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b001, 3);
-        break;
-    }
-    case FullScaleRange::FSR_2048mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b010, 3);
-        break;
-    }
-    case FullScaleRange::FSR_1024mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b011, 3);
-        break;
-    }
-    case FullScaleRange::FSR_0512mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b100, 3);
-        break;
-    }
-    case FullScaleRange::FSR_0256mV: {
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b101, 3);
-        break;
+    setBit(&config_reg, use(CONFIG_REGISTER::CONF_MODE), 1);    // Single-shot
+    if (not write(Register::CONFIG_REGISTER, config_reg)) { return _error; }
+    _config = config_reg;
+    return Result::SUCCESS;
+}
+
+void ADS1x1x::miss() {
+    _rail.off();
+    if (_presence.isAbsent()) {
+        _presence.backoff();
+        set(State::ABSENT);
+        return;
     }
-    default: {
-        // Default FSR is 2048mV in both ADS101x and ADS111x
-        setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0), 0b010, 3);
-        break;
+    if (not _presence.miss(millis())) { return; }
+    ++_stats.detaches;
+    set(State::ABSENT);
+}
+
+ADS1x1x::Result ADS1x1x::failRead() {
+    if (in(State::ABSENT)) {
+        setError(Result::FAILED_NOT_RESPONDING);
+        return _error;
     }
+    if (in(State::IDLE) and _failure != Result::SUCCESS) {
+        // A request given up in update() is reported once
+        setError(_failure);
+        _failure = Result::SUCCESS;
+        return _error;
     }
+    setError(Result::FAILED_BUSY);
+    return _error;
+}
+
+ADS1x1x::Result ADS1x1x::applyFullScaleRange() {
+    uint16_t config_reg;
+    if (not read(Register::CONFIG_REGISTER, &config_reg)) { return _error; }
+    setPattern(&config_reg, use(CONFIG_REGISTER::CONF_PGA0),
+               pgaOf(_settings.full_scale_range), 3);
     if (not write(Register::CONFIG_REGISTER, config_reg)) { return _error; }
     return Result::SUCCESS;
 }
@@ -262,53 +460,80 @@ ADS1x1x::Result ADS1x1x::applyDataRate() {
     return Result::SUCCESS;
 }
 
-// MARK: Common I2C utils (private)
+ADS1x1x::Result ADS1x1x::start(const uint16_t config_reg) {
+    if (not write(Register::CONFIG_REGISTER, config_reg)) { return _error; }
+    _request_config = config_reg;
+    set(State::BUSY);
+    // The conversion starts when the config write completes
+    const uint32_t started = micros();
+    _timing.start(started);
+    _energy.addConversion(CONVERSION_CURRENT, 1000000 / use(_settings.data_rate));
+    // Twice the datasheet time
+    _deadline = started + _timing.getNominal() * 2;
+    _values.timestamp = started + _timing.getLearned() / 2;
+    return Result::SUCCESS;
+}
 
-ADS1x1x::Result ADS1x1x::read(const Register reg, uint8_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-    } else {
-        setError(Result::FAILED_NOT_RESPONDING);
-        return _error;
+ADS1x1x::FullScaleRange ADS1x1x::pickRange(const uint8_t mux) const {
+    const FullScaleRange widest = _settings.full_scale_range;
+    if (_levels[mux] == LEVEL_UNKNOWN) { return widest; }
+    // The ranges below 6144 mV are 256 mV doubled
+    const uint32_t level = _levels[mux] * 100UL;
+    uint32_t fsr = use(FullScaleRange::FSR_0256mV);
+    while (fsr < static_cast<uint32_t>(use(widest)) and level > fsr * AUTO_RANGE_FILL) {
+        fsr *= 2;
     }
-    if (auto&& reader = Wire.get_reader(use(_address), 1)) {
-        reader >> *dst;
-    } else {
-        setError(Result::FAILED_NOT_RESPONDING);
-        return _error;
+    if (fsr >= static_cast<uint32_t>(use(widest))) { return widest; }
+    return static_cast<FullScaleRange>(fsr);
+}
+
+uint8_t ADS1x1x::pgaOf(const FullScaleRange fsr) {
+    switch (fsr) {
+    case FullScaleRange::FSR_6144mV: return 0b000;
+    case FullScaleRange::FSR_4096mV: return 0b001;
+    case FullScaleRange::FSR_2048mV: return 0b010;
+    case FullScaleRange::FSR_1024mV: return 0b011;
+    case FullScaleRange::FSR_0512mV: return 0b100;
+    case FullScaleRange::FSR_0256mV: return 0b101;
+    // Default FSR is 2048mV in both ADS101x and ADS111x
+    default: return 0b010;
     }
-    return ADS1x1x::Result::SUCCESS;
 }
 
-ADS1x1x::Result ADS1x1x::read(const ADS1x1x::Register reg, uint16_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-    } else {
+// MARK: Common I2C utils (private)
+
+ADS1x1x::Result ADS1x1x::read(const Register reg, uint8_t* const dst) {
+    // Address, register, address again, data
+    _energy.addBytes(4);
+    if (not _bus->readRegister(use(_address), use(reg), dst, 1, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
-    if (auto&& reader = Wire.get_reader(use(_address), 2)) {
-        uint8_t byte1, byte2;
-        reader >> byte1;
-        reader >> byte2;
-        *dst = (byte1 << 8) | byte2;
-    } else {
+    return Result::SUCCESS;
+}
+
+ADS1x1x::Result ADS1x1x::read(const Register reg, uint16_t* const dst) {
+    uint8_t bytes[2];
+    _energy.addBytes(5);
+    if (not _bus->readRegister(use(_address), use(reg), bytes, 2, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
+    *dst = (bytes[0] << 8) | bytes[1];
     return Result::SUCCESS;
 }
 
 ADS1x1x::Result ADS1x1x::write(const Register reg, const int src) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-        if (src <= 0xFF) {
-            writer << src;
-        } else {
-            writer << ((src >> 8) & 0xFF);
-            writer << (src & 0xFF);
-        }
+    uint8_t bytes[3] = { use(reg) };
+    uint8_t length = 1;
+    if (src <= 0xFF) {
+        bytes[length++] = src;
     } else {
+        bytes[length++] = (src >> 8) & 0xFF;
+        bytes[length++] = src & 0xFF;
+    }
+    _energy.addBytes(length + 1);
+    if (not _bus->write(use(_address), bytes, length, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
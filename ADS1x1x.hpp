@@ -17,6 +17,13 @@
  */
 #include <TWELITE>
 
+#include "ConversionTimeEstimator.hpp"
+#include "EnergyMeter.hpp"
+#include "Histogram.hpp"
+#include "I2CBus.hpp"
+#include "PowerRail.hpp"
+#include "PresenceMonitor.hpp"
+
 /**
  * @class ADS1x1x
  * @brief Interface for the device.
@@ -202,6 +209,21 @@ public:
 private:
     // MARK: Constants (private)
 
+    /// Time from power-on until the adc accepts its configuration (us)
+    static const uint16_t POWER_UP_TIME = 50;
+
+    /// Current drawn during a conversion (uA)
+    static const uint16_t CONVERSION_CURRENT = 150;
+
+    /// Number of input multiplexer settings
+    static const int MUX_COUNT = 8;
+
+    /// Largest predicted level an automatic range is picked for (% of full scale)
+    static const uint8_t AUTO_RANGE_FILL = 75;
+
+    /// Level of an input not measured yet, or that saturated its range
+    static const uint16_t LEVEL_UNKNOWN = 0xFFFF;
+
     /**
      * @brief Calculate the conversion delay based on the data rate.
      *
@@ -237,6 +259,7 @@ private:
      * - `COMPLETE`: Conversion completed successfully.
      * - `ERROR`: An error occurred during conversion.
      * - `AVAILABLE`: Data is ready to be read.
+     * - `ABSENT`: The adc stopped responding and is probed for its return.
      */
     enum class State : int {
         WAIT_SETUP,    ///< Waiting for setup to complete.
@@ -245,7 +268,8 @@ private:
         BUSY,          ///< Conversion in progress.
         COMPLETE,      ///< Conversion successful.
         ERROR,         ///< Error during conversion.
-        AVAILABLE      ///< Data is ready for reading.
+        AVAILABLE,     ///< Data is ready for reading.
+        ABSENT         ///< ADC is unplugged; probed for its return.
     };
     /**
      * @brief Helper function to retrieve the numeric value of a State enum.
@@ -265,6 +289,17 @@ private:
      */
     inline bool in(const State state) { return _state == state; }
 
+    /**
+     * @brief Enters the error state, keeping the first error of the request.
+     *
+     * Later errors of calls made meanwhile do not replace the cause reported by
+     * `read()`.
+     */
+    inline void fail() {
+        if (_failure == Result::SUCCESS) { _failure = _error; }
+        set(State::ERROR);
+    }
+
 public:
     // MARK: Results (public)
 
@@ -278,6 +313,7 @@ public:
         SUCCESS,                  ///< Operation completed successfully.
         FAILED_NOT_RESPONDING,    ///< ADC is not responding.
         FAILED_BUSY,              ///< ADC is busy with another operation.
+        FAILED_TIMEOUT,           ///< ADC did not complete in time.
         FAILED_UNKNOWN            ///< An unknown error occurred.
     };
 
@@ -306,6 +342,31 @@ public:
      */
     friend Result operator||(Result lhs, Result rhs);
 
+public:
+    // MARK: Statistics (public)
+
+    /**
+     * @brief Counters and learned timing of the adc.
+     *
+     * The conversion time is learned from the OS bit of the config register (see
+     * `ConversionTimeEstimator`); a ratio below 1 means the part converts faster
+     * than `getConversionDelay()`.
+     */
+    struct Stats {
+        uint32_t samples;            ///< Completed conversions
+        uint32_t status_polls;       ///< Config reads while a conversion runs
+        uint32_t timeouts;           ///< Conversions not ready in time
+        uint32_t reconversions;      ///< Conversions repeated after saturating
+        uint32_t detaches;           ///< Times the adc was found unplugged
+        uint32_t reattaches;         ///< Times the adc came back
+        uint32_t rail_on_time;       ///< Total on-time of the power rail (us)
+        uint32_t rail_on_time_last;  ///< Rail on-time of the latest request (us)
+        uint32_t energy_total;       ///< Modelled energy of all requests (uJ)
+        uint32_t energy_last;        ///< Modelled energy of the latest sample (nJ)
+        uint32_t conversion_time;    ///< Learned conversion time (us)
+        float conversion_ratio;      ///< Learned / nominal conversion time
+    };
+
 private:
     // MARK: Registers (private)
 
@@ -385,21 +446,86 @@ private:
     /// I2C address of the adc
     Address _address;
 
+    /// I2C bus the device is connected to
+    I2CBus* _bus;
+
+    /// `true` while the device holds a reference to the bus
+    bool _bus_acquired;
+
+    /// Fastest I2C speed supported by the device
+    I2CBus::Speed _max_speed;
+
     /// Configuration settings for the adc
     Settings _settings;
 
     /// Device type
     DeviceType _device_type;
 
-    /// Last time data requested
-    uint32_t _latest_request_time;
-
     /// Latest measured values
     struct {
-        uint16_t raw;
-        uint16_t voltage;
+        int16_t raw;          ///< Latest signed conversion result (counts)
+        uint16_t voltage;     ///< Latest voltage (mV)
+        uint32_t timestamp;   ///< Midpoint of the conversion (us)
+        FullScaleRange range; ///< Full-scale range of the conversion
     } _values;
 
+    /// `true` if each request picks its own full-scale range
+    bool _auto_range;
+
+    /// Latest level of each input, by multiplexer setting (mV)
+    uint16_t _levels[MUX_COUNT];
+
+    /// Config register that started the running conversion
+    uint16_t _request_config;
+
+    /// Learned duration of a conversion
+    ConversionTimeEstimator _timing;
+
+    /// Unplug and return detection
+    PresenceMonitor _presence;
+
+    /// Switched supply of the adc
+    PowerRail _rail;
+
+    /// Modelled energy of the conversions and the bus traffic
+    EnergyMeter _energy;
+
+    /// Recent longest duration of one step of `update()` (us)
+    uint32_t _step_cost;
+
+    /// Time of the latest `request()` (us)
+    uint32_t _requested_at;
+
+    /// Config reads of the request in progress
+    uint16_t _request_polls;
+
+    /// Time from `request()` to `available()` (us)
+    DiagnosticHistogram<72> _latency;
+
+    /// Config reads per completed request
+    DiagnosticHistogram<24> _polls;
+
+    /// Duration of the `update()` calls that did work (us)
+    DiagnosticHistogram<48> _update_time;
+
+    /// Config register written by `begin()`, restored after each power-on
+    uint16_t _config;
+
+    /// Mode suspended by `onSleep()`
+    struct {
+        bool asleep;        ///< `true` between `onSleep()` and `onWakeup()`
+        bool continuous;    ///< `true` if the adc was converting continuously
+    } _sleep;
+
+    /// Time the running conversion is given up (us)
+    uint32_t _deadline;
+
+    /// First error of the current request, reported by `read()` if it fails
+    Result _failure;
+
+    /// Counters of the adc
+    Stats _stats;
+
 public:
     // MARK: Const/Destructor (public)
 
@@ -411,9 +537,13 @@ public:
      */
     ADS1x1x()
         : _state(State::WAIT_SETUP), _address(Address::PRIMARY),
-          _device_type(DeviceType::ADS101x),
-          _settings(Settings(Settings::Presets::DEFAULT)), _latest_request_time(0),
-          _values { 0 } {}
+          _bus(&I2CBus::getDefault()), _bus_acquired(false),
+          _max_speed(I2CBus::Speed::HIGH_SPEED),
+          _settings(Settings(Settings::Presets::DEFAULT)),
+          _device_type(DeviceType::ADS101x), _values { 0 },
+          _auto_range(false), _levels {}, _request_config(0), _step_cost(0),
+          _requested_at(0), _request_polls(0), _config(0), _sleep { false, false },
+          _deadline(0), _failure(Result::SUCCESS), _stats {} {}
 
     /**
      * @brief Destructor for the ADS1x1x class.
@@ -453,6 +583,45 @@ public:
      */
     inline void setAddress(const Address address) { _address = address; }
 
+    /**
+     * @brief Retrieves the I2C bus the device is connected to.
+     * @return A reference to the bus.
+     */
+    inline I2CBus& getBus() { return *_bus; }
+
+    /**
+     * @brief Sets the I2C bus the device is connected to.
+     *
+     * The hardware I2C bus on the default pins is used unless another bus is set.
+     * Call before `begin()`; a bus held by a running device is handed over.
+     *
+     * @param bus The bus to use.
+     */
+    inline void setBus(I2CBus& bus) {
+        if (_bus_acquired) {
+            _bus->release();
+            _bus_acquired = bus.acquire();
+        }
+        _bus = &bus;
+    }
+
+    /**
+     * @brief Retrieves the fastest I2C speed used for the device.
+     * @return The speed limit of the device.
+     */
+    inline I2CBus::Speed getMaxSpeed() const { return _max_speed; }
+
+    /**
+     * @brief Sets the fastest I2C speed used for the device.
+     *
+     * The ADS1x1x supports up to High-speed mode (3.4 MHz). The transactions run at
+     * the fastest speed allowed by both this setting and the bus (see
+     * `I2CBus::setMaxSpeed()`).
+     *
+     * @param speed The speed limit of the device.
+     */
+    inline void setMaxSpeed(const I2CBus::Speed speed) { _max_speed = speed; }
+
     /**
      * @brief Retrieves the current adc settings.
      *
@@ -473,6 +642,123 @@ public:
      */
     inline void setSettings(const Settings& settings) { _settings = settings; }
 
+    /**
+     * @brief Enables or disables the automatic full-scale range.
+     *
+     * Each request then picks the smallest range that holds the previous level of
+     * its input with `AUTO_RANGE_FILL` % to spare, up to `full_scale_range` of the
+     * settings, and writes it in the config write that starts the conversion. A
+     * result that saturates a smaller range is converted once more at
+     * `full_scale_range`. An input not measured yet starts at `full_scale_range`.
+     *
+     * @param enable `true` to pick the range per request.
+     */
+    inline void setAutoRange(const bool enable) {
+        _auto_range = enable;
+        for (int i = 0; i < MUX_COUNT; ++i) { _levels[i] = LEVEL_UNKNOWN; }
+    }
+
+    /// `true` if each request picks its own full-scale range.
+    inline bool isAutoRange() const { return _auto_range; }
+
+    /**
+     * @brief Retrieves the full-scale range of the latest conversion.
+     *
+     * With the automatic range, the voltage is rounded to 1 mV; scale the raw
+     * result by this range for the full resolution.
+     *
+     * @return The range.
+     */
+    inline FullScaleRange getRange() const { return _values.range; }
+
+    /**
+     * @brief Sets a pin that switches the supply of the adc.
+     *
+     * The driver then turns the rail on only for each request. `begin()` configures
+     * the adc once and caches its config register; each request waits
+     * `POWER_UP_TIME`, starts the conversion with that config in one write and turns
+     * the rail off as soon as the result is read out. Call before `begin()`.
+     *
+     * @param pin Enable pin, or `PowerRail::NO_PIN` for an always-on supply.
+     * @param active_high `true` if the rail is on while the pin is high.
+     */
+    inline void setPowerPin(const uint8_t pin, const bool active_high = true) {
+        _rail.setup(pin, active_high);
+    }
+
+    /**
+     * @brief Retrieves the energy model of the adc.
+     *
+     * Each conversion is charged with `CONVERSION_CURRENT` for one period of the
+     * data rate, and each I2C byte with the bus energy of the model; set the supply
+     * voltage and the bus energy of the board through the returned meter. A sample
+     * is one request, from `request()` to `available()`.
+     *
+     * @return A reference to the meter.
+     */
+    inline EnergyMeter& getEnergyMeter() { return _energy; }
+
+    /**
+     * @brief Retrieves the distribution of the time from `request()` to
+     * `available()` (us), of the completed requests.
+     *
+     * This includes the interval between `update()` calls. Up to about 0.46 s is
+     * bucketed, which covers the slowest data rate.
+     *
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<72>& getLatencyHistogram() const {
+        return _latency;
+    }
+
+    /**
+     * @brief Retrieves the distribution of the config reads per completed request.
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<24>& getPollHistogram() const {
+        return _polls;
+    }
+
+    /**
+     * @brief Retrieves the distribution of the duration of `update()` (us).
+     *
+     * Only the calls that read the adc or changed the state are counted.
+     *
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<48>& getUpdateHistogram() const {
+        return _update_time;
+    }
+
+    /**
+     * @brief Retrieves the counters and the learned timing of the adc.
+     *
+     * The learned timing restarts from the datasheet value on each `begin()`.
+     *
+     * @return The statistics.
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Clears the counters; the learned timing is kept.
+     */
+    inline void clearStats() {
+        _stats.samples = 0;
+        _stats.status_polls = 0;
+        _stats.timeouts = 0;
+        _stats.reconversions = 0;
+        _stats.detaches = 0;
+        _stats.reattaches = 0;
+        _rail.clear();
+        _energy.clear();
+        _latency.clear();
+        _polls.clear();
+        _update_time.clear();
+    }
+
 private:
     // MARK: Set/Get (private)
 
@@ -504,6 +790,10 @@ private:
             snprintf_(_error_message, sizeof(_error_message),
                       "Error: ADS1x1x is not responding");
             break;
+        case Result::FAILED_TIMEOUT:
+            snprintf_(_error_message, sizeof(_error_message),
+                      "Error: ADS1x1x timed out");
+            break;
         case Result::FAILED_UNKNOWN:
             snprintf_(_error_message, sizeof(_error_message),
                       "Error: Unknown issue with ADS1x1x");
@@ -565,8 +855,15 @@ public:
      *
      * Updates the adc's state and handles ongoing conversion tasks. This function
      * should be called periodically in the main loop to maintain adc functionality.
+     *
+     * A call takes one step, a status poll or the result read; with a budget, it
+     * also reads a result found ready if the recent longest step still fits.
+     *
+     * @param budget Time the call may take (us); 0 for a single step.
+     * @return `true` if work is left that the next call can do at once; otherwise,
+     *     `false`.
      */
-    void update();
+    bool update(const uint32_t budget = 0);
 
     /**
      * @brief End conversions.
@@ -585,19 +882,56 @@ public:
      */
     inline bool available() { return in(ADS1x1x::State::AVAILABLE); }
 
+    /**
+     * @brief Check if the adc is taken as unplugged.
+     *
+     * After `PresenceMonitor::ABSENT_AFTER` consecutive requests failed with
+     * `FAILED_NOT_RESPONDING`, requests fail at once and `update()` only probes
+     * for the adc at a backed-off interval. When it acknowledges again, the
+     * settings are written back and it becomes idle.
+     *
+     * @return `true` if the adc is absent; otherwise, `false`.
+     */
+    inline bool isAbsent() { return in(ADS1x1x::State::ABSENT); }
+
+    /**
+     * @brief Check if the adc accepts a request.
+     *
+     * A request that is neither available nor pending any more was given up;
+     * `read()` then reports why.
+     *
+     * @return `true` if the adc is idle; otherwise, `false`.
+     */
+    inline bool isIdle() { return in(ADS1x1x::State::IDLE); }
+
+    /**
+     * @brief Retrieves the learned conversion time.
+     * @return The time from a request to its result being ready (us).
+     */
+    inline uint32_t getConversionTime() const { return _timing.getLearned(); }
+
+    /**
+     * @brief Retrieves when the latest conversion was sampled.
+     * @return The midpoint of the latest conversion (us, as `micros()`).
+     */
+    inline uint32_t getTimestamp() const { return _values.timestamp; }
+
     /**
      * @brief Prepare the adc for sleep mode.
      *
-     * Performs any necessary steps to put the adc into a low-power state.
+     * Switches a continuously converting adc to single-shot mode, which powers down
+     * after the current conversion. A single-shot conversion in progress is left
+     * to finish.
      */
-    inline void onSleep() const {}
+    void onSleep();
 
     /**
      * @brief Wake the adc from sleep mode.
      *
-     * Restores the adc from a low-power state, preparing it for operation.
+     * Takes the result of a conversion that finished during the sleep without
+     * polling for it, or restores the continuous mode. `begin()` is not needed.
      */
-    inline void onWakeup() const {}
+    void onWakeup();
 
     /**
      * @brief Request conversion with the specific channel.
@@ -613,7 +947,9 @@ public:
      * @brief Read voltage data after a conversion request.
      *
      * Retrieves the voltage data converted by the adc.
-     * Ensure `request()` has been called before using this method.
+     * Ensure `request()` has been called before using this method. A request given
+     * up in `update()`, by a timeout or an unanswered poll, leaves the adc idle and
+     * is reported once here with its first error.
      *
      * @param voltage Pointer to store the voltage value (mV).
      * @return `ADS1x1x::Result` indicating the success or failure of the read
@@ -621,9 +957,51 @@ public:
      */
     Result read(uint16_t* const voltage);
 
+    /**
+     * @brief Read voltage and raw count data after a conversion request.
+     *
+     * Retrieves the voltage and the signed conversion result (12-bit for ADS101x,
+     * 16-bit for ADS111x) converted by the adc.
+     * Ensure `request()` has been called before using this method. A request given
+     * up in `update()` is reported once, like `read(uint16_t* const)`.
+     *
+     * @param voltage Pointer to store the voltage value (mV).
+     * @param raw Pointer to store the raw conversion result (counts).
+     * @return `ADS1x1x::Result` indicating the success or failure of the read
+     * operation.
+     */
+    Result read(uint16_t* const voltage, int16_t* const raw);
+
 private:
     // MARK: Specific utils (private)
 
+    /**
+     * @brief Take one step of `update()`.
+     */
+    void step();
+
+    /**
+     * @brief Write the settings and single-shot mode to the adc.
+     * @return `ADS1x1x::Result` indicating the success or failure of the operation.
+     */
+    Result initialize();
+
+    /**
+     * @brief Count a request lost to an unresponsive adc, and detach it after
+     * enough of them.
+     *
+     * A failed power-up attempt while absent only backs off the next attempt.
+     */
+    void miss();
+
+    /**
+     * @brief Report why no result can be read.
+     *
+     * @return `FAILED_NOT_RESPONDING` while absent; the first error of a request
+     *     given up in `update()`, once; otherwise, `FAILED_BUSY`.
+     */
+    Result failRead();
+
     /**
      * @brief Apply saved full scale range configurations from settings.
      *
@@ -644,6 +1022,27 @@ private:
      */
     Result applyDataRate();
 
+    /**
+     * @brief Start a conversion with a config register, and time it.
+     * @param config_reg Config register with OS set.
+     * @return `ADS1x1x::Result` indicating the success or failure of the write.
+     */
+    Result start(const uint16_t config_reg);
+
+    /**
+     * @brief Pick the automatic full-scale range of an input.
+     * @param mux Multiplexer setting of the input.
+     * @return The smallest range that holds the previous level of the input.
+     */
+    FullScaleRange pickRange(const uint8_t mux) const;
+
+    /**
+     * @brief Retrieves the PGA bits of a full-scale range.
+     * @param fsr The range.
+     * @return The value of `CONF_PGA`; the 2048 mV setting for an unknown range.
+     */
+    static uint8_t pgaOf(const FullScaleRange fsr);
+
 private:
     // MARK: Common I2C utils (private)
 
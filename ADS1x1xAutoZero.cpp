@@ -0,0 +1,115 @@
+// -*- coding:utf-8-unix -*-
+
+#include "ADS1x1xAutoZero.hpp"
+
+// MARK: Interfaces (public)
+
+void ADS1x1xAutoZero::setup(const ADS1x1x::ChannelConfig signal,
+                            const ADS1x1x::ChannelConfig zero, const uint8_t interval,
+                            const Mode mode) {
+    _signal = signal;
+    _zero = zero;
+    _interval = interval < 1 ? 1 : interval > MAX_INTERVAL ? MAX_INTERVAL : interval;
+    _mode = mode;
+    set(State::WAIT_BEGIN);
+}
+
+void ADS1x1xAutoZero::begin() {
+    if (not in(State::WAIT_BEGIN)) { end(); }
+    // The zero only holds for the range it was converted at
+    _adc->setAutoRange(false);
+    _adc->begin();
+    _pending.running = false;
+    _offset.valid = false;
+    _since_zero = 0;
+    _head = 0;
+    _corrected = 0;
+    _tail = 0;
+    _dropped = 0;
+    set(State::RUNNING);
+}
+
+void ADS1x1xAutoZero::update() {
+    if (not in(State::RUNNING)) { return; }
+    _adc->update();
+    if (_adc->available()) {
+        uint16_t voltage;
+        int16_t raw;
+        const bool read = _adc->read(&voltage, &raw) == ADS1x1x::Result::SUCCESS;
+        if (read and _pending.running) {
+            if (_pending.zero) {
+                addZero(raw, _adc->getTimestamp());
+            } else {
+                addSample(raw, _adc->getTimestamp());
+            }
+        }
+        _pending.running = false;
+    }
+    if (not _adc->isIdle()) { return; }
+    // A conversion still pending here was given up by the adc; start another
+    const bool zero = not _offset.valid or _since_zero >= _interval;
+    if (_adc->request(zero ? _zero : _signal) != ADS1x1x::Result::SUCCESS) { return; }
+    _pending.running = true;
+    _pending.zero = zero;
+}
+
+void ADS1x1xAutoZero::end() {
+    _adc->end();
+    _pending.running = false;
+    _head = 0;
+    _corrected = 0;
+    _tail = 0;
+    if (in(State::WAIT_SETUP)) { return; }
+    set(State::WAIT_BEGIN);
+}
+
+ADS1x1x::Result ADS1x1xAutoZero::read(int16_t* const raw, uint32_t* const timestamp) {
+    if (not available()) { return ADS1x1x::Result::FAILED_BUSY; }
+    *raw = _samples[_tail];
+    *timestamp = _timestamps[_tail];
+    _tail = next(_tail);
+    return ADS1x1x::Result::SUCCESS;
+}
+
+// MARK: Specific utils (private)
+
+void ADS1x1xAutoZero::addSample(const int16_t raw, const uint32_t timestamp) {
+    if (next(_head) == _tail) {
+        // Full; the reader is behind, so give up its oldest sample
+        if (_tail == _corrected) { _corrected = next(_corrected); }
+        _tail = next(_tail);
+        ++_dropped;
+    }
+    _samples[_head] = raw;
+    _timestamps[_head] = timestamp;
+    if (_mode == Mode::HOLD) {
+        subtract(_head, _offset.raw);
+        _corrected = next(_head);
+    }
+    _head = next(_head);
+    ++_since_zero;
+}
+
+void ADS1x1xAutoZero::addZero(const int16_t raw, const uint32_t timestamp) {
+    if (_mode == Mode::INTERPOLATE and _offset.valid) {
+        // The offset moves linearly from the previous zero to this one
+        const int32_t step = raw - _offset.raw;
+        const float span = timestamp - _offset.timestamp;
+        for (uint8_t slot = _corrected; slot != _head; slot = next(slot)) {
+            const float drift = step * ((_timestamps[slot] - _offset.timestamp) / span);
+            const int32_t rounded = static_cast<int32_t>(drift < 0 ? drift - 0.5f :
+                                                                     drift + 0.5f);
+            subtract(slot, _offset.raw + rounded);
+        }
+        _corrected = _head;
+    }
+    _offset.valid = true;
+    _offset.raw = raw;
+    _offset.timestamp = timestamp;
+    _since_zero = 0;
+}
+
+void ADS1x1xAutoZero::subtract(const uint8_t slot, const int32_t offset) {
+    const int32_t value = _samples[slot] - offset;
+    _samples[slot] = value > 0x7FFF ? 0x7FFF : value < -0x8000 ? -0x8000 : value;
+}
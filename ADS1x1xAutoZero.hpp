@@ -0,0 +1,242 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   ADS1x1xAutoZero.hpp
+ * @brief  Offset drift removal for ADS1x1x by interleaved zero measurements.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "ADS1x1x.hpp"
+
+/**
+ * @class ADS1x1xAutoZero
+ * @brief Converts a signal input with a zero input every `interval` samples, and
+ * subtracts the tracked offset.
+ *
+ * The multiplexer of the ADS1x1x cannot swap the two pins of a differential input,
+ * so the offset is not chopped out by reversing the polarity. Instead, a second
+ * input whose pins are tied together on the board (for example `AIN2_AIN3` with
+ * AIN2 wired to AIN3) is converted at the same range after every `interval`
+ * signal conversions. Its result is the offset of the adc at that moment.
+ *
+ * With `Mode::INTERPOLATE`, the samples between two zero conversions are held
+ * until the second one completes, and each gets the offset interpolated at its
+ * sampling instant; this follows a drift without lag, at a latency of `interval`
+ * samples. With `Mode::HOLD`, each sample gets the latest zero at once.
+ *
+ * One conversion in `interval` + 1 is spent on the zero. The zero is noisy like
+ * any conversion; a longer interval adds less of its noise per sample but follows
+ * a faster drift worse.
+ *
+ * Both inputs are converted at `full_scale_range` of the adc settings; `begin()`
+ * turns the automatic range off. The results are corrected counts, to be scaled
+ * like raw results (e.g. by `ADS1x1xCalibration` with a zero offset entry).
+ */
+class ADS1x1xAutoZero {
+public:
+    // MARK: Settings (public)
+
+    /**
+     * @brief Enum class for how the offset is applied to the samples.
+     */
+    enum class Mode : uint8_t {
+        INTERPOLATE,    ///< Offset interpolated between the surrounding zeros
+        HOLD            ///< Offset of the latest zero, without latency
+    };
+
+    /// Largest number of signal conversions between two zero conversions
+    static const uint8_t MAX_INTERVAL = 32;
+
+private:
+    // MARK: Constants (private)
+
+    /// Slots of the sample ring; room for one held block and one unread block
+    static const uint8_t RING = 2 * MAX_INTERVAL;
+
+private:
+    // MARK: States (private)
+
+    /**
+     * @brief Enumeration of internal states for the auto-zero.
+     */
+    enum class State : int {
+        WAIT_SETUP,    ///< Waiting for setup to complete.
+        WAIT_BEGIN,    ///< Waiting for the begin signal.
+        RUNNING        ///< The inputs are being converted.
+    };
+
+    /**
+     * @brief Sets the state of the auto-zero.
+     * @param state The new state.
+     */
+    inline void set(const State state) { _state = state; }
+
+    /**
+     * @brief Checks if the auto-zero is in a specific state.
+     * @param state The state to check.
+     * @return `true` if the auto-zero is in the given state; otherwise, `false`.
+     */
+    inline bool in(const State state) { return _state == state; }
+
+private:
+    // MARK: Variables (private)
+
+    /// Current state of the auto-zero
+    State _state;
+
+    /// The adc
+    ADS1x1x* _adc;
+
+    /// Input measured
+    ADS1x1x::ChannelConfig _signal;
+
+    /// Input with its pins tied together
+    ADS1x1x::ChannelConfig _zero;
+
+    /// Signal conversions between two zero conversions
+    uint8_t _interval;
+
+    /// How the offset is applied
+    Mode _mode;
+
+    /// `true` while a conversion is running, and whether it is the zero
+    struct {
+        bool running;    ///< `true` while a conversion is running
+        bool zero;       ///< `true` if it converts the zero input
+    } _pending;
+
+    /// Signal conversions since the latest zero conversion
+    uint8_t _since_zero;
+
+    /// Latest zero
+    struct {
+        bool valid;            ///< `true` once a zero was converted
+        int16_t raw;           ///< Result of the zero input (counts)
+        uint32_t timestamp;    ///< Sampling instant (us)
+    } _offset;
+
+    /// Samples, corrected in place once their offset is known
+    int16_t _samples[RING];
+
+    /// Sampling instants of the samples (us)
+    uint32_t _timestamps[RING];
+
+    /// Slot of the next sample
+    uint8_t _head;
+
+    /// Slot of the oldest sample not corrected yet
+    uint8_t _corrected;
+
+    /// Slot of the oldest unread sample
+    uint8_t _tail;
+
+    /// Corrected samples replaced before they were read
+    uint32_t _dropped;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the auto-zero.
+     * @param adc The adc, set up by the application.
+     */
+    ADS1x1xAutoZero(ADS1x1x& adc)
+        : _state(State::WAIT_SETUP), _adc(&adc),
+          _signal(ADS1x1x::ChannelConfig::AIN0_AIN1),
+          _zero(ADS1x1x::ChannelConfig::AIN2_AIN3), _interval(8),
+          _mode(Mode::INTERPOLATE), _pending {}, _since_zero(0), _offset {},
+          _samples {}, _timestamps {}, _head(0), _corrected(0), _tail(0),
+          _dropped(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Setup the auto-zero.
+     *
+     * @param signal Input to measure.
+     * @param zero Input whose pins are tied together on the board.
+     * @param interval Signal conversions between two zero conversions, from 1 to
+     *     `MAX_INTERVAL`.
+     * @param mode How the offset is applied.
+     */
+    void setup(const ADS1x1x::ChannelConfig signal, const ADS1x1x::ChannelConfig zero,
+               const uint8_t interval = 8, const Mode mode = Mode::INTERPOLATE);
+
+    /**
+     * @brief Begin the adc and start with a zero conversion.
+     */
+    void begin();
+
+    /**
+     * @brief Update the adc, take its result and start the next conversion.
+     *
+     * Call periodically in the main loop.
+     */
+    void update();
+
+    /**
+     * @brief End the adc; unread samples are discarded.
+     */
+    void end();
+
+    /**
+     * @brief Check if a corrected sample is available for reading.
+     * @return `true` if a sample is available; otherwise, `false`.
+     */
+    inline bool available() const { return _tail != _corrected; }
+
+    /**
+     * @brief Read the oldest corrected sample.
+     *
+     * @param raw Pointer to store the result minus the offset (counts).
+     * @param timestamp Pointer to store the sampling instant (us, as `micros()`).
+     * @return `ADS1x1x::Result` indicating the success or failure of the read
+     *     operation.
+     */
+    ADS1x1x::Result read(int16_t* const raw, uint32_t* const timestamp);
+
+    /// Latest result of the zero input (counts).
+    inline int16_t getOffset() const { return _offset.raw; }
+
+    /// Corrected samples replaced before they were read.
+    inline uint32_t getDropped() const { return _dropped; }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Store a signal sample, and correct it at once with `Mode::HOLD`.
+     * @param raw Result of the signal input (counts).
+     * @param timestamp Sampling instant (us).
+     */
+    void addSample(const int16_t raw, const uint32_t timestamp);
+
+    /**
+     * @brief Take a zero, and correct the held samples with `Mode::INTERPOLATE`.
+     * @param raw Result of the zero input (counts).
+     * @param timestamp Sampling instant (us).
+     */
+    void addZero(const int16_t raw, const uint32_t timestamp);
+
+    /**
+     * @brief Subtract an offset from a sample, saturating at the 16-bit limits.
+     * @param slot Slot of the sample.
+     * @param offset The offset (counts).
+     */
+    void subtract(const uint8_t slot, const int32_t offset);
+
+    /// Slot after a slot.
+    static inline uint8_t next(const uint8_t slot) { return (slot + 1) % RING; }
+};
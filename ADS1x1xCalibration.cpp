@@ -0,0 +1,164 @@
+// -*- coding:utf-8-unix -*-
+
+#include "ADS1x1xCalibration.hpp"
+
+namespace {
+/// Ranges in the order of the table columns
+const ADS1x1x::FullScaleRange RANGE_ORDER[ADS1x1xCalibration::RANGES] = {
+    ADS1x1x::FullScaleRange::FSR_6144mV, ADS1x1x::FullScaleRange::FSR_4096mV,
+    ADS1x1x::FullScaleRange::FSR_2048mV, ADS1x1x::FullScaleRange::FSR_1024mV,
+    ADS1x1x::FullScaleRange::FSR_0512mV, ADS1x1x::FullScaleRange::FSR_0256mV
+};
+}    // namespace
+
+// MARK: Interfaces (public)
+
+void ADS1x1xCalibration::clear() {
+    for (int input = 0; input < INPUTS; ++input) {
+        for (int range = 0; range < RANGES; ++range) {
+            Entry& entry = _entries[input][range];
+            entry.offset = 0;
+            entry.gain = GAIN_ONE;
+            updateFactor(&entry, RANGE_ORDER[range]);
+        }
+    }
+}
+
+void ADS1x1xCalibration::setEntry(const ADS1x1x::ChannelConfig channel,
+                                  const ADS1x1x::FullScaleRange fsr,
+                                  const int16_t offset, const uint16_t gain) {
+    Entry& entry = _entries[inputOf(channel)][rangeOf(fsr)];
+    entry.offset = offset;
+    entry.gain = gain;
+    updateFactor(&entry, fsr);
+}
+
+void ADS1x1xCalibration::apply(const ADS1x1x::ChannelConfig channel,
+                               const ADS1x1x::FullScaleRange fsr,
+                               const int16_t* const raw, int32_t* const microvolts,
+                               const int count) const {
+    const Entry entry = entryOf(channel, fsr);
+    for (int i = 0; i < count; ++i) { microvolts[i] = correct(entry, raw[i]); }
+}
+
+void ADS1x1xCalibration::apply(const ADS1x1x::ChannelConfig channel,
+                               const ADS1x1x::FullScaleRange fsr,
+                               const int16_t* const ring, const int capacity,
+                               const int first, int32_t* const microvolts,
+                               const int count) const {
+    // At most two contiguous runs: up to the end of the buffer, then from its start
+    const int head = count < capacity - first ? count : capacity - first;
+    apply(channel, fsr, ring + first, microvolts, head);
+    apply(channel, fsr, ring, microvolts + head, count - head);
+}
+
+ADS1x1x::Result ADS1x1xCalibration::captureOffset(ADS1x1x& adc,
+                                                  const ADS1x1x::ChannelConfig channel,
+                                                  const ADS1x1x::FullScaleRange fsr,
+                                                  const uint8_t samples) {
+    int32_t mean;
+    const ADS1x1x::Result result = measure(adc, channel, fsr, samples, &mean);
+    if (result != ADS1x1x::Result::SUCCESS) { return result; }
+    setEntry(channel, fsr, mean, getGain(channel, fsr));
+    return ADS1x1x::Result::SUCCESS;
+}
+
+ADS1x1x::Result ADS1x1xCalibration::captureGain(ADS1x1x& adc,
+                                                const ADS1x1x::ChannelConfig channel,
+                                                const ADS1x1x::FullScaleRange fsr,
+                                                const int32_t reference,
+                                                const uint8_t samples) {
+    int32_t mean;
+    const ADS1x1x::Result result = measure(adc, channel, fsr, samples, &mean);
+    if (result != ADS1x1x::Result::SUCCESS) { return result; }
+    const int16_t offset = getOffset(channel, fsr);
+    // Counts an ideal adc would read for the reference
+    const float ideal = reference * static_cast<float>(getFullCode())
+        / (ADS1x1x::use(fsr) * 1000.0f);
+    const int32_t counts = mean - offset;
+    if (counts == 0) { return ADS1x1x::Result::FAILED_UNKNOWN; }
+    const float gain = ideal / counts;
+    if (not (gain >= 0.5f and gain < 2.0f)) { return ADS1x1x::Result::FAILED_UNKNOWN; }
+    setEntry(channel, fsr, offset, static_cast<uint16_t>(gain * GAIN_ONE + 0.5f));
+    return ADS1x1x::Result::SUCCESS;
+}
+
+// MARK: Specific utils (private)
+
+void ADS1x1xCalibration::updateFactor(Entry* const entry,
+                                      const ADS1x1x::FullScaleRange fsr) const {
+    // uV per count, corrected by the gain
+    float scale = ADS1x1x::use(fsr) * 1000.0f / getFullCode()
+        * entry->gain / GAIN_ONE;
+    // As many fraction bits as keep the factor below 2^15, so that a product with
+    // a 16-bit result stays in 32 bits
+    uint8_t shift = 0;
+    while (scale * 2 < 0x8000 and shift < 30) {
+        scale *= 2;
+        ++shift;
+    }
+    entry->factor = static_cast<uint16_t>(scale + 0.5f);
+    entry->shift = shift;
+}
+
+ADS1x1x::Result ADS1x1xCalibration::measure(ADS1x1x& adc,
+                                            const ADS1x1x::ChannelConfig channel,
+                                            const ADS1x1x::FullScaleRange fsr,
+                                            const uint8_t samples, int32_t* const mean) {
+    // Requests use the range of the settings while the automatic range is off
+    ADS1x1x::Settings& settings = adc.getSettings();
+    const ADS1x1x::FullScaleRange saved_range = settings.full_scale_range;
+    const bool saved_auto_range = adc.isAutoRange();
+    settings.full_scale_range = fsr;
+    adc.setAutoRange(false);
+
+    ADS1x1x::Result result = ADS1x1x::Result::SUCCESS;
+    int32_t sum = 0;
+    for (int i = 0; i < samples and result == ADS1x1x::Result::SUCCESS; ++i) {
+        result = adc.request(channel);
+        if (result != ADS1x1x::Result::SUCCESS) { break; }
+        while (not adc.available()) {
+            adc.update();
+            // The adc gave up the conversion
+            if (adc.isIdle() or adc.isAbsent()) {
+                result = ADS1x1x::Result::FAILED_TIMEOUT;
+                break;
+            }
+        }
+        if (result != ADS1x1x::Result::SUCCESS) { break; }
+        uint16_t voltage;
+        int16_t raw;
+        result = adc.read(&voltage, &raw);
+        sum += raw;
+    }
+
+    settings.full_scale_range = saved_range;
+    adc.setAutoRange(saved_auto_range);
+    if (result != ADS1x1x::Result::SUCCESS) { return result; }
+    if (samples == 0) { return ADS1x1x::Result::FAILED_UNKNOWN; }
+    // Rounded to the nearest count
+    *mean = (sum >= 0 ? sum + samples / 2 : sum - samples / 2) / samples;
+    return ADS1x1x::Result::SUCCESS;
+}
+
+int ADS1x1xCalibration::inputOf(const ADS1x1x::ChannelConfig channel) {
+    switch (channel) {
+    case ADS1x1x::ChannelConfig::AIN0_AIN1: return 0;
+    case ADS1x1x::ChannelConfig::AIN0_AIN3: return 1;
+    case ADS1x1x::ChannelConfig::AIN1_AIN3: return 2;
+    case ADS1x1x::ChannelConfig::AIN2_AIN3: return 3;
+    case ADS1x1x::ChannelConfig::AIN0_GND: return 4;
+    case ADS1x1x::ChannelConfig::AIN1_GND: return 5;
+    case ADS1x1x::ChannelConfig::AIN2_GND: return 6;
+    case ADS1x1x::ChannelConfig::AIN3_GND: return 7;
+    default: return 0;
+    }
+}
+
+int ADS1x1xCalibration::rangeOf(const ADS1x1x::FullScaleRange fsr) {
+    for (int range = 0; range < RANGES; ++range) {
+        if (RANGE_ORDER[range] == fsr) { return range; }
+    }
+    // Default FSR is 2048mV in both ADS101x and ADS111x
+    return 2;
+}
@@ -0,0 +1,264 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   ADS1x1xCalibration.hpp
+ * @brief  Per-input, per-range offset and gain correction of ADS1x1x results.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "ADS1x1x.hpp"
+
+/**
+ * @class ADS1x1xCalibration
+ * @brief Table of offset and gain corrections, applied to raw results in integers.
+ *
+ * Each input (`ChannelConfig`) has its own entry for each `FullScaleRange`, since
+ * the PGA setting changes both the offset in counts and the gain error. An entry
+ * holds:
+ * - the offset, in counts, read with the input shorted;
+ * - the gain, in units of 1/`GAIN_ONE`, that maps the offset-corrected counts to
+ *   the true voltage.
+ *
+ * Setting an entry folds the gain and the size of one count into a single 15-bit
+ * factor with its own shift, so a result is corrected and scaled to microvolts
+ * with one subtraction, one multiplication and one shift:
+ * \f[
+ * \mu V = ((raw - offset) \cdot factor + 2^{shift - 1}) \gg shift
+ * \f]
+ *
+ * Entries start at offset 0 and gain 1. Fill them from a factory table with
+ * `setEntry()`, or measure them on the bench with `captureOffset()` and
+ * `captureGain()`.
+ */
+class ADS1x1xCalibration {
+public:
+    // MARK: Constants (public)
+
+    /// Gain of 1
+    static const uint16_t GAIN_ONE = 0x8000;
+
+    /// Number of inputs
+    static const int INPUTS = 8;
+
+    /// Number of full-scale ranges
+    static const int RANGES = 6;
+
+    /// Default number of conversions averaged by the capture routines
+    static const uint8_t DEFAULT_CAPTURE_SAMPLES = 16;
+
+private:
+    // MARK: Variables (private)
+
+    /// Resolution of the results
+    ADS1x1x::DeviceType _device_type;
+
+    /// Corrections, by input and range
+    struct Entry {
+        int16_t offset;     ///< Result of a shorted input (counts)
+        uint16_t gain;      ///< Gain correction (1/`GAIN_ONE`)
+        uint16_t factor;    ///< Gain times the size of one count (uV >> shift)
+        uint8_t shift;      ///< Fraction bits of `factor`
+    } _entries[INPUTS][RANGES];
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the calibration.
+     * @param device_type Device type of the adc, which sets the size of one count.
+     */
+    ADS1x1xCalibration(
+        const ADS1x1x::DeviceType device_type = ADS1x1x::DeviceType::ADS101x)
+        : _device_type(device_type), _entries {} {
+        clear();
+    }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Reset every entry to offset 0 and gain 1.
+     */
+    void clear();
+
+    /**
+     * @brief Sets the correction of an input at a range.
+     *
+     * @param channel The input.
+     * @param fsr The range.
+     * @param offset Result of the input shorted (counts).
+     * @param gain Gain correction (1/`GAIN_ONE`), below 2.
+     */
+    void setEntry(const ADS1x1x::ChannelConfig channel,
+                  const ADS1x1x::FullScaleRange fsr, const int16_t offset,
+                  const uint16_t gain);
+
+    /// Offset of an input at a range (counts).
+    inline int16_t getOffset(const ADS1x1x::ChannelConfig channel,
+                             const ADS1x1x::FullScaleRange fsr) const {
+        return entryOf(channel, fsr).offset;
+    }
+
+    /// Gain correction of an input at a range (1/`GAIN_ONE`).
+    inline uint16_t getGain(const ADS1x1x::ChannelConfig channel,
+                            const ADS1x1x::FullScaleRange fsr) const {
+        return entryOf(channel, fsr).gain;
+    }
+
+    /**
+     * @brief Correct and scale one result.
+     *
+     * @param channel Input of the conversion.
+     * @param fsr Range of the conversion (see `ADS1x1x::getRange()`).
+     * @param raw Raw result (counts).
+     * @return The corrected voltage (uV).
+     */
+    inline int32_t apply(const ADS1x1x::ChannelConfig channel,
+                         const ADS1x1x::FullScaleRange fsr, const int16_t raw) const {
+        const Entry& entry = entryOf(channel, fsr);
+        return correct(entry, raw);
+    }
+
+    /**
+     * @brief Correct and scale a run of results of one input at one range.
+     *
+     * The entry is looked up once, so the loop is only the multiply-add.
+     *
+     * @param channel Input of the conversions.
+     * @param fsr Range of the conversions.
+     * @param raw Raw results (counts).
+     * @param microvolts Array to store the corrected voltages (uV).
+     * @param count Number of results.
+     */
+    void apply(const ADS1x1x::ChannelConfig channel, const ADS1x1x::FullScaleRange fsr,
+               const int16_t* const raw, int32_t* const microvolts,
+               const int count) const;
+
+    /**
+     * @brief Correct and scale results held in a ring buffer.
+     *
+     * @param channel Input of the conversions.
+     * @param fsr Range of the conversions.
+     * @param ring The ring buffer of raw results (counts).
+     * @param capacity Number of slots of the ring buffer.
+     * @param first Slot of the oldest result to correct.
+     * @param microvolts Array to store the corrected voltages, oldest first (uV).
+     * @param count Number of results, at most `capacity`.
+     */
+    void apply(const ADS1x1x::ChannelConfig channel, const ADS1x1x::FullScaleRange fsr,
+               const int16_t* const ring, const int capacity, const int first,
+               int32_t* const microvolts, const int count) const;
+
+    /**
+     * @brief Measure the offset of an input that is shorted, and store it.
+     *
+     * Blocks for `samples` conversions. The adc must have begun; its range and
+     * automatic range are restored afterwards. The gain of the entry is kept.
+     *
+     * @param adc The adc.
+     * @param channel The input, with both of its pins at the same voltage.
+     * @param fsr The range to calibrate.
+     * @param samples Number of conversions to average.
+     * @return `ADS1x1x::Result` indicating the success or failure of the capture.
+     */
+    ADS1x1x::Result captureOffset(ADS1x1x& adc, const ADS1x1x::ChannelConfig channel,
+                                  const ADS1x1x::FullScaleRange fsr,
+                                  const uint8_t samples = DEFAULT_CAPTURE_SAMPLES);
+
+    /**
+     * @brief Measure the gain of an input fed with a reference voltage, and store it.
+     *
+     * Capture the offset of the range first. Blocks like `captureOffset()`. A gain
+     * outside 0.5 to 2 is rejected with `FAILED_UNKNOWN`, as the reference is then
+     * more likely wrong than the adc.
+     *
+     * @param adc The adc.
+     * @param channel The input, fed with the reference.
+     * @param fsr The range to calibrate; the reference should be near its top.
+     * @param reference The reference voltage (uV).
+     * @param samples Number of conversions to average.
+     * @return `ADS1x1x::Result` indicating the success or failure of the capture.
+     */
+    ADS1x1x::Result captureGain(ADS1x1x& adc, const ADS1x1x::ChannelConfig channel,
+                                const ADS1x1x::FullScaleRange fsr,
+                                const int32_t reference,
+                                const uint8_t samples = DEFAULT_CAPTURE_SAMPLES);
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Correct and scale a result with an entry.
+     * @param entry The entry.
+     * @param raw Raw result (counts).
+     * @return The corrected voltage (uV).
+     */
+    static inline int32_t correct(const Entry& entry, const int16_t raw) {
+        const int32_t counts = static_cast<int32_t>(raw) - entry.offset;
+        const int32_t half = static_cast<int32_t>(1) << (entry.shift - 1);
+        return (counts * entry.factor + half) >> entry.shift;
+    }
+
+    /**
+     * @brief Retrieves the entry of an input at a range.
+     * @param channel The input.
+     * @param fsr The range.
+     * @return A reference to the entry.
+     */
+    inline const Entry& entryOf(const ADS1x1x::ChannelConfig channel,
+                                const ADS1x1x::FullScaleRange fsr) const {
+        return _entries[inputOf(channel)][rangeOf(fsr)];
+    }
+
+    /**
+     * @brief Recompute the factor and shift of an entry from its gain.
+     * @param entry The entry.
+     * @param fsr The range of the entry.
+     */
+    void updateFactor(Entry* const entry, const ADS1x1x::FullScaleRange fsr) const;
+
+    /**
+     * @brief Average the raw results of an input at a range.
+     *
+     * @param adc The adc.
+     * @param channel The input.
+     * @param fsr The range.
+     * @param samples Number of conversions.
+     * @param mean Pointer to store the mean result (counts).
+     * @return `ADS1x1x::Result` indicating the success or failure of the conversions.
+     */
+    static ADS1x1x::Result measure(ADS1x1x& adc, const ADS1x1x::ChannelConfig channel,
+                                   const ADS1x1x::FullScaleRange fsr,
+                                   const uint8_t samples, int32_t* const mean);
+
+    /// Largest result of the device type (counts).
+    inline int32_t getFullCode() const {
+        return _device_type == ADS1x1x::DeviceType::ADS111x ? 0x7FFF : 0x7FF;
+    }
+
+    /**
+     * @brief Retrieves the table row of an input.
+     * @param channel The input.
+     * @return The row, in the order of the multiplexer setting.
+     */
+    static int inputOf(const ADS1x1x::ChannelConfig channel);
+
+    /**
+     * @brief Retrieves the table column of a range.
+     * @param fsr The range.
+     * @return The column, from the widest range; the 2048 mV column for an unknown
+     *     range.
+     */
+    static int rangeOf(const ADS1x1x::FullScaleRange fsr);
+};
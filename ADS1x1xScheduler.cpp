@@ -0,0 +1,155 @@
+// -*- coding:utf-8-unix -*-
+
+#include "ADS1x1xScheduler.hpp"
+
+// MARK: Interfaces (public)
+
+int8_t ADS1x1xScheduler::addChannel(const ADS1x1x::ChannelConfig config,
+                                    const uint32_t period) {
+    if (not in(State::WAIT_BEGIN) or _count >= MAX_CHANNELS or period == 0) {
+        return NO_CHANNEL;
+    }
+    // Keep the table ordered by priority; equal periods in the order added
+    int index = _count;
+    while (index > 0 and _channels[index - 1].period > period) {
+        _channels[index] = _channels[index - 1];
+        --index;
+    }
+    Channel& channel = _channels[index];
+    channel = Channel {};
+    channel.config = config;
+    channel.period = period;
+    ++_count;
+    return index;
+}
+
+void ADS1x1xScheduler::clearChannels() {
+    if (not in(State::WAIT_BEGIN)) { return; }
+    _count = 0;
+}
+
+void ADS1x1xScheduler::begin() {
+    if (not in(State::WAIT_BEGIN)) { end(); }
+    _adc->begin();
+    const uint32_t now = micros();
+    for (int i = 0; i < _count; ++i) { _channels[i].release = now; }
+    _running = NO_CHANNEL;
+    clearStats();
+    set(State::RUNNING);
+}
+
+void ADS1x1xScheduler::update() {
+    if (in(State::WAIT_BEGIN)) { return; }
+    _adc->update();
+    if (_adc->available()) { collect(); }
+    if (not _adc->isIdle()) { return; }
+    if (_running != NO_CHANNEL) {
+        // The adc gave up the conversion
+        ++_channels[_running].errors;
+        _running = NO_CHANNEL;
+    }
+    dispatch(micros());
+}
+
+void ADS1x1xScheduler::end() {
+    _adc->end();
+    _running = NO_CHANNEL;
+    set(State::WAIT_BEGIN);
+}
+
+ADS1x1x::Result ADS1x1xScheduler::read(int8_t* const channel, uint16_t* const voltage,
+                                       int16_t* const raw) {
+    if (not in(State::AVAILABLE)) { return ADS1x1x::Result::FAILED_BUSY; }
+    *channel = _values.channel;
+    *voltage = _values.voltage;
+    *raw = _values.raw;
+    set(State::RUNNING);
+    return ADS1x1x::Result::SUCCESS;
+}
+
+ADS1x1xScheduler::ChannelStats ADS1x1xScheduler::getChannelStats(const int index) const {
+    const Channel& channel = _channels[index];
+    ChannelStats stats;
+    stats.samples = channel.samples;
+    stats.skipped = channel.skipped;
+    stats.errors = channel.errors;
+    stats.interval = channel.interval;
+    stats.rate = channel.interval > 0 ? 1000000.0f / channel.interval : 0;
+    stats.lateness_p50 = channel.lateness.getP50();
+    stats.lateness_p99 = channel.lateness.getP99();
+    stats.lateness_max = channel.lateness.getMax();
+    return stats;
+}
+
+float ADS1x1xScheduler::getUtilization() const {
+    const float busy = _adc->getConversionTime() + _guard;
+    float utilization = 0;
+    for (int i = 0; i < _count; ++i) { utilization += busy / _channels[i].period; }
+    return utilization;
+}
+
+void ADS1x1xScheduler::clearStats() {
+    for (int i = 0; i < _count; ++i) {
+        Channel& channel = _channels[i];
+        channel.interval = 0;
+        channel.samples = 0;
+        channel.skipped = 0;
+        channel.errors = 0;
+        channel.lateness.clear();
+    }
+}
+
+// MARK: Specific utils (private)
+
+void ADS1x1xScheduler::dispatch(const uint32_t now) {
+    const uint32_t end = now + _adc->getConversionTime() + _guard;
+    for (int i = 0; i < _count; ++i) {
+        Channel& channel = _channels[i];
+        if (static_cast<int32_t>(now - channel.release) < 0) { continue; }
+        uint32_t lateness = now - channel.release;
+        if (lateness >= channel.period) {
+            // Stay on the grid instead of catching up with a burst
+            const uint32_t missed = lateness / channel.period;
+            channel.skipped += missed;
+            channel.release += missed * channel.period;
+            lateness -= missed * channel.period;
+        }
+        if (lateness < channel.period / 2 and not fits(i, end)) { continue; }
+        if (_adc->request(channel.config) != ADS1x1x::Result::SUCCESS) { return; }
+        channel.lateness.add(lateness);
+        channel.release += channel.period;
+        _running = i;
+        return;
+    }
+}
+
+void ADS1x1xScheduler::collect() {
+    uint16_t voltage;
+    int16_t raw;
+    if (_adc->read(&voltage, &raw) != ADS1x1x::Result::SUCCESS) { return; }
+    if (_running == NO_CHANNEL) { return; }
+    Channel& channel = _channels[_running];
+    const uint32_t sampled_at = _adc->getTimestamp();
+    if (channel.samples > 0) {
+        const uint32_t interval = sampled_at - channel.sampled_at;
+        if (channel.interval == 0) {
+            channel.interval = interval;
+        } else {
+            channel.interval += static_cast<int32_t>(interval - channel.interval) / 16;
+        }
+    }
+    channel.sampled_at = sampled_at;
+    ++channel.samples;
+    _values.channel = _running;
+    _values.voltage = voltage;
+    _values.raw = raw;
+    _running = NO_CHANNEL;
+    set(State::AVAILABLE);
+}
+
+bool ADS1x1xScheduler::fits(const int index, const uint32_t end) const {
+    for (int i = 0; i < index; ++i) {
+        if (static_cast<int32_t>(end - _channels[i].release) > 0) { return false; }
+    }
+    return true;
+}
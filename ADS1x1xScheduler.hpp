@@ -0,0 +1,286 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   ADS1x1xScheduler.hpp
+ * @brief  Rate-monotonic scheduling of ADS1x1x channels with individual periods.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "ADS1x1x.hpp"
+#include "Histogram.hpp"
+
+/**
+ * @class ADS1x1xScheduler
+ * @brief Samples each channel of one adc at its own period.
+ *
+ * Every channel is released once per period; when the adc is idle, the due channel
+ * with the shortest period is converted first (rate-monotonic priority). A slower
+ * channel is only started in a gap: if its conversion would still run at the next
+ * release of a faster channel, it waits. A channel that has waited half its period
+ * is started in the next free slot anyway, delaying a faster channel by at most one
+ * conversion, so it is not starved.
+ *
+ * Releases follow a fixed grid, so a late start does not shift the later ones. A
+ * release that passes entirely without a conversion is counted as skipped.
+ *
+ * The conversion time is the learned one of the adc, so the data rate must leave
+ * room for all channels: the sum of conversion time / period (`getUtilization()`)
+ * should stay well below 1. For 500 Hz on one channel, use a data rate of 1600 SPS
+ * or more.
+ */
+class ADS1x1xScheduler {
+public:
+    // MARK: Constants (public)
+
+    /// Maximum number of channels
+    static const int MAX_CHANNELS = 8;
+
+    /// Time allowed for the request and read-out transactions of a conversion (us)
+    static const uint32_t DEFAULT_GUARD_TIME = 400;
+
+    /// Index meaning no channel
+    static const int8_t NO_CHANNEL = -1;
+
+public:
+    // MARK: Statistics (public)
+
+    /**
+     * @brief Achieved rate and timing of a channel.
+     *
+     * The lateness is the time from the release of a channel to the start of its
+     * conversion; its spread is the jitter of the sampling instants. Without
+     * `HISTOGRAM_DIAGNOSTICS`, its percentiles read as its maximum.
+     */
+    struct ChannelStats {
+        uint32_t samples;         ///< Completed conversions
+        uint32_t skipped;         ///< Releases that passed without a conversion
+        uint32_t errors;          ///< Conversions started but not completed
+        uint32_t interval;        ///< Mean interval between sampling instants (us)
+        float rate;               ///< Achieved rate (Hz); 0 before two samples
+        uint32_t lateness_p50;    ///< Median lateness (us)
+        uint32_t lateness_p99;    ///< 99th percentile of the lateness (us)
+        uint32_t lateness_max;    ///< Largest lateness (us)
+    };
+
+private:
+    // MARK: States (private)
+
+    /**
+     * @brief Enumeration of internal states for the scheduler.
+     */
+    enum class State : int {
+        WAIT_BEGIN,    ///< Waiting for the begin signal.
+        RUNNING,       ///< Channels are being sampled.
+        AVAILABLE      ///< A result is ready to be read.
+    };
+
+    /**
+     * @brief Sets the state of the scheduler.
+     * @param state The new state.
+     */
+    inline void set(const State state) { _state = state; }
+
+    /**
+     * @brief Checks if the scheduler is in a specific state.
+     * @param state The state to check.
+     * @return `true` if the scheduler is in the given state; otherwise, `false`.
+     */
+    inline bool in(const State state) { return _state == state; }
+
+private:
+    // MARK: Variables (private)
+
+    /// Current state of the scheduler
+    State _state;
+
+    /// The adc
+    ADS1x1x* _adc;
+
+    /// Time allowed for the transactions of a conversion (us)
+    uint32_t _guard;
+
+    /// The channels, by increasing period
+    struct Channel {
+        ADS1x1x::ChannelConfig config;    ///< Input of the channel
+        uint32_t period;                  ///< Sampling period (us)
+        uint32_t release;                 ///< Next release (us, as `micros()`)
+        uint32_t sampled_at;              ///< Latest sampling instant (us)
+        uint32_t interval;                ///< Mean sampling interval (us)
+        uint32_t samples;                 ///< Completed conversions
+        uint32_t skipped;                 ///< Releases passed without a conversion
+        uint32_t errors;                  ///< Conversions lost
+        DiagnosticHistogram<48> lateness; ///< Release to start of conversion (us)
+    } _channels[MAX_CHANNELS];
+
+    /// Number of channels
+    uint8_t _count;
+
+    /// Channel being converted, or `NO_CHANNEL`
+    int8_t _running;
+
+    /// Latest result
+    struct {
+        int8_t channel;      ///< Index of the channel
+        uint16_t voltage;    ///< Voltage (mV)
+        int16_t raw;         ///< Conversion result (counts)
+    } _values;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the scheduler.
+     * @param adc The adc, set up by the application in single-shot mode.
+     */
+    ADS1x1xScheduler(ADS1x1x& adc)
+        : _state(State::WAIT_BEGIN), _adc(&adc), _guard(DEFAULT_GUARD_TIME),
+          _channels {}, _count(0), _running(NO_CHANNEL),
+          _values { NO_CHANNEL, 0, 0 } {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Add a channel; only before `begin()`.
+     *
+     * @param config Input of the channel.
+     * @param period Sampling period (us).
+     * @return The index of the channel, or `NO_CHANNEL` if the table is full, the
+     *     period is 0 or the scheduler is running. Adding a channel renumbers the
+     *     channels with a longer period.
+     */
+    int8_t addChannel(const ADS1x1x::ChannelConfig config, const uint32_t period);
+
+    /**
+     * @brief Remove all channels; only before `begin()`.
+     */
+    void clearChannels();
+
+    /**
+     * @brief Sets the time allowed for the transactions of a conversion.
+     *
+     * It is added to the conversion time when checking whether a slow channel fits
+     * before the next release of a faster one. Raise it for a slow bus or a main
+     * loop that calls `update()` seldom.
+     *
+     * @param guard Time (us).
+     */
+    inline void setGuardTime(const uint32_t guard) { _guard = guard; }
+
+    /**
+     * @brief Begin the adc and release all channels.
+     */
+    void begin();
+
+    /**
+     * @brief Update the adc, collect its result and start the next channel.
+     *
+     * Call periodically in the main loop, faster than the shortest period.
+     */
+    void update();
+
+    /**
+     * @brief End the adc; the channels are kept.
+     */
+    void end();
+
+    /**
+     * @brief Check if a result is available for reading.
+     *
+     * A result not read before the next one completes is replaced.
+     *
+     * @return `true` if a result is available; otherwise, `false`.
+     */
+    inline bool available() { return in(State::AVAILABLE); }
+
+    /**
+     * @brief Read the latest result.
+     *
+     * @param channel Pointer to store the index of the channel.
+     * @param voltage Pointer to store the voltage value (mV).
+     * @param raw Pointer to store the raw conversion result (counts).
+     * @return `ADS1x1x::Result` indicating the success or failure of the read
+     *     operation.
+     */
+    ADS1x1x::Result read(int8_t* const channel, uint16_t* const voltage,
+                         int16_t* const raw);
+
+    /// Number of channels.
+    inline uint8_t getChannelCount() const { return _count; }
+
+    /**
+     * @brief Retrieves the input of a channel.
+     * @param index Index from 0 to `getChannelCount()` - 1.
+     * @return The input.
+     */
+    inline ADS1x1x::ChannelConfig getChannel(const int index) const {
+        return _channels[index].config;
+    }
+
+    /**
+     * @brief Retrieves the achieved rate and timing of a channel.
+     * @param index Index from 0 to `getChannelCount()` - 1.
+     * @return The statistics.
+     */
+    ChannelStats getChannelStats(const int index) const;
+
+    /**
+     * @brief Retrieves the distribution of the lateness of a channel (us).
+     * @param index Index from 0 to `getChannelCount()` - 1.
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<48>& getLatenessHistogram(const int index) const {
+        return _channels[index].lateness;
+    }
+
+    /**
+     * @brief Retrieves the share of the adc time the channels need.
+     *
+     * Computed from the learned conversion time and the guard time. Above about
+     * 0.7, slow channels start to delay fast ones; above 1, releases are skipped.
+     *
+     * @return The sum of busy time / period over the channels.
+     */
+    float getUtilization() const;
+
+    /**
+     * @brief Clears the statistics of all channels.
+     */
+    void clearStats();
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Start the due channel with the highest priority that fits.
+     * @param now Current time, as `micros()`.
+     */
+    void dispatch(const uint32_t now);
+
+    /**
+     * @brief Read the result of the running channel and update its statistics.
+     */
+    void collect();
+
+    /**
+     * @brief Check whether a conversion ends before every faster channel is due.
+     *
+     * @param index Index of the channel to start.
+     * @param end Time the conversion would end (us, as `micros()`).
+     * @return `true` if no faster channel is released before `end`; otherwise,
+     *     `false`.
+     */
+    bool fits(const int index, const uint32_t end) const;
+};
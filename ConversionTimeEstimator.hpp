@@ -0,0 +1,153 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   ConversionTimeEstimator.hpp
+ * @brief  Online estimate of the real conversion time of a device.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class ConversionTimeEstimator
+ * @brief Learns how long a conversion really takes from the ready bit.
+ *
+ * Datasheet timings are worst case; the oscillator of each part is usually faster.
+ * The driver reports every status poll with `observe()`. The last poll that saw the
+ * conversion running and the first poll that saw it ready bracket the completion
+ * time; the midpoint of that bracket is one sample.
+ *
+ * The estimate is a running mean with a running mean absolute deviation, both with
+ * a weight of 1/8. A sample further than four deviations from the estimate is
+ * clipped to that distance, so one late poll (e.g. a long radio callback) does not
+ * drag the estimate.
+ *
+ * The first status poll is scheduled before the estimate by a safety margin of two
+ * deviations, at least 1/32 of the estimate. When the first poll already sees the
+ * result, the sample is that poll time; the estimate then creeps earlier until a
+ * poll sees the conversion still running.
+ *
+ * All times are in microseconds.
+ */
+class ConversionTimeEstimator {
+private:
+    // MARK: Variables (private)
+
+    /// Datasheet conversion time
+    uint32_t _nominal;
+
+    /// Estimated conversion time
+    uint32_t _learned;
+
+    /// Mean absolute deviation of the samples
+    uint32_t _deviation;
+
+    /// Number of samples learned from
+    uint32_t _samples;
+
+    /// Start of the current conversion
+    uint32_t _started;
+
+    /// Time since start of the last poll that saw the conversion running
+    uint32_t _running;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the estimator.
+     */
+    ConversionTimeEstimator()
+        : _nominal(0), _learned(0), _deviation(0), _samples(0), _started(0),
+          _running(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Forget the learned time and start again from the datasheet time.
+     * @param nominal Datasheet conversion time.
+     */
+    inline void reset(const uint32_t nominal) {
+        _nominal = _learned = nominal;
+        _deviation = nominal / 8;
+        _samples = 0;
+    }
+
+    /**
+     * @brief Mark the start of a conversion.
+     * @param now Current time, as `micros()`.
+     */
+    inline void start(const uint32_t now) {
+        _started = now;
+        _running = 0;
+    }
+
+    /**
+     * @brief Check whether the first status poll is due.
+     * @param now Current time, as `micros()`.
+     * @return `true` once the scheduled first poll time has passed.
+     */
+    inline bool due(const uint32_t now) const {
+        return now - _started >= getFirstCheck();
+    }
+
+    /**
+     * @brief Report the outcome of a status poll.
+     *
+     * @param now Time of the poll, as `micros()`.
+     * @param ready `true` if the poll saw the conversion complete.
+     */
+    void observe(const uint32_t now, const bool ready) {
+        const uint32_t elapsed = now - _started;
+        if (not ready) {
+            _running = elapsed;
+            return;
+        }
+        const uint32_t sample = _running > 0 ? (_running + elapsed) / 2 : elapsed;
+        const int32_t limit = static_cast<int32_t>(_deviation * 4 + 1);
+        int32_t error = static_cast<int32_t>(sample - _learned);
+        if (error > limit) { error = limit; }
+        if (error < -limit) { error = -limit; }
+        _learned += error / 8;
+        const int32_t spread = error < 0 ? -error : error;
+        _deviation += (spread - static_cast<int32_t>(_deviation)) / 8;
+        ++_samples;
+    }
+
+    /**
+     * @brief Retrieves the time after the start at which to poll first.
+     * @return The estimate minus the safety margin.
+     */
+    inline uint32_t getFirstCheck() const {
+        const uint32_t margin =
+            _deviation * 2 > _learned / 32 ? _deviation * 2 : _learned / 32;
+        return _learned > margin ? _learned - margin : 0;
+    }
+
+    /// Estimated conversion time.
+    inline uint32_t getLearned() const { return _learned; }
+
+    /// Datasheet conversion time.
+    inline uint32_t getNominal() const { return _nominal; }
+
+    /// Number of samples learned from.
+    inline uint32_t getSamples() const { return _samples; }
+
+    /**
+     * @brief Retrieves the estimated time relative to the datasheet time.
+     * @return Learned / nominal; below 1 for a part faster than the datasheet.
+     */
+    inline float getRatio() const {
+        return _nominal > 0 ? static_cast<float>(_learned) / _nominal : 0;
+    }
+};
@@ -13,62 +13,131 @@ void DPS310::setup(const Address address, const Settings& settings) {
 
 void DPS310::begin() {
     if (not in(State::WAIT_BEGIN)) { end(); }
-    Wire.begin();
+    if (not acquireBus()) {
+        setError(Result::FAILED_NOT_RESPONDING);
+        return;
+    }
+    _rail.on();
     delay(50);    // Wait for device startup
-    if (not(readId() == GENUINE_PRODUCT_ID)) { return; }
-    if (not softReset()) { return; }
-    if (not applyPressureSettings()) { return; }
-    if (not applyTemperatureSettings()) { return; }
-    if (not applyOperationMode(OperationMode::STANDBY)) { return; }
+    resetTiming();
+    _power_up_timing.reset(POWER_UP_TIME * 1000);
+    if (not applyInterface() or not(readId() == GENUINE_PRODUCT_ID)
+        or not initialize()) {
+        _rail.off();
+        if (_error == Result::FAILED_NOT_RESPONDING) {
+            // Not plugged in yet; update() or request() looks for it
+            _presence.lost(millis());
+            set(State::ABSENT);
+        }
+        return;
+    }
+    // The coefficients are cached; each request powers the device again
+    _rail.off();
     set(State::IDLE);
 }
 
-void DPS310::update() {
+bool DPS310::update(const uint32_t budget) {
+    const uint32_t started = micros();
+    const State entered = _state;
+    const uint32_t polls = _stats.status_polls;
+    uint32_t before = started;
+    bool work;
+    while (true) {
+        step();
+        const uint32_t now = micros();
+        const uint32_t cost = now - before;
+        // Forget a slow step gradually, e.g. one stretched by an interrupt
+        _step_cost = cost > _step_cost ? cost : _step_cost - (_step_cost - cost) / 16;
+        work = hasWork();
+        if (not work or budget == 0 or now - started + _step_cost > budget) { break; }
+        before = now;
+    }
+    if (_state != entered or _stats.status_polls != polls) {
+        _update_time.add(micros() - started);
+    }
+    return work;
+}
+
+void DPS310::step() {
     switch (_state) {
     case State::TEMP_BUSY: {
+        const uint32_t now = micros();
+        // Leave the bus alone until just before the learned completion time
+        if (not _temperature_timing.due(now)) { break; }
         uint8_t meas_cfg;
-        if (not read(Register::MEAS_CFG, &meas_cfg)) { set(State::TEMP_ERROR); }
-        if (hasBitSet(meas_cfg, use(MEAS_CFG::TMP_RDY))) { set(State::TEMP_COMPLETE); }
+        if (not read(Register::MEAS_CFG, &meas_cfg)) {
+            fail(State::TEMP_ERROR);
+            break;
+        }
+        ++_stats.status_polls;
+        ++_request_polls;
+        const bool ready = hasBitSet(meas_cfg, use(MEAS_CFG::TMP_RDY));
+        _temperature_timing.observe(now, ready);
+        if (ready) {
+            set(State::TEMP_COMPLETE);
+        } else if (static_cast<int32_t>(now - _deadline) >= 0) {
+            ++_stats.timeouts;
+            setError(Result::FAILED_TIMEOUT);
+            fail(State::TEMP_ERROR);
+        }
         break;
     }
     case State::TEMP_COMPLETE: {
-        uint8_t temp_msb, temp_mid, temp_lsb;
-        if (not read(Register::TMP_B2, &temp_msb)) { set(State::TEMP_ERROR); }
-        if (not read(Register::TMP_B1, &temp_mid)) { set(State::TEMP_ERROR); }
-        if (not read(Register::TMP_B0, &temp_lsb)) { set(State::TEMP_ERROR); }
+        uint8_t temp[3];    // TMP_B2, TMP_B1, TMP_B0
+        if (not read(Register::TMP_B2, temp, 3)) {
+            // Do not decode a partially read result
+            fail(State::TEMP_ERROR);
+            break;
+        }
 
-        float tmp_reg =
-            twosComplement((temp_msb << 16) | (temp_mid << 8) | temp_lsb, 24);
+        float tmp_reg = twosComplement((temp[0] << 16) | (temp[1] << 8) | temp[2], 24);
         _values.t_raw_scaled =
             tmp_reg / getScaleFactorFor(_settings.temperature_precision);
 
         _values.temperature = 0.5f * _coef.c0 + _coef.c1 * _values.t_raw_scaled;
 
         // Next, measure pressure
-        set(State::PRES_BUSY);
-        if (not applyOperationMode(OperationMode::ONE_SHOT_PRESSURE)) {
-            set(State::PRES_ERROR);
-        }
+        set(State::PRES_PENDING);
         break;
     }
     case State::TEMP_ERROR: {
-        set(State::IDLE);
+        escalate(false);
+        break;
+    }
+    case State::PRES_PENDING: {
+        if (not startPressure()) { fail(State::PRES_ERROR); }
         break;
     }
     case State::PRES_BUSY: {
+        const uint32_t now = micros();
+        if (not _pressure_timing.due(now)) { break; }
         uint8_t meas_cfg;
-        if (not read(Register::MEAS_CFG, &meas_cfg)) { set(State::PRES_ERROR); }
-        if (hasBitSet(meas_cfg, use(MEAS_CFG::PRS_RDY))) { set(State::PRES_COMPLETE); }
+        if (not read(Register::MEAS_CFG, &meas_cfg)) {
+            fail(State::PRES_ERROR);
+            break;
+        }
+        ++_stats.status_polls;
+        ++_request_polls;
+        const bool ready = hasBitSet(meas_cfg, use(MEAS_CFG::PRS_RDY));
+        _pressure_timing.observe(now, ready);
+        if (ready) {
+            set(State::PRES_COMPLETE);
+        } else if (static_cast<int32_t>(now - _deadline) >= 0) {
+            ++_stats.timeouts;
+            setError(Result::FAILED_TIMEOUT);
+            fail(State::PRES_ERROR);
+        }
         break;
     }
     case State::PRES_COMPLETE: {
-        uint8_t pres_msb, pres_mid, pres_lsb;
-        if (not read(Register::PRS_B2, &pres_msb)) { set(State::PRES_ERROR); }
-        if (not read(Register::PRS_B1, &pres_mid)) { set(State::PRES_ERROR); }
-        if (not read(Register::PRS_B0, &pres_lsb)) { set(State::PRES_ERROR); }
+        uint8_t pres[3];    // PRS_B2, PRS_B1, PRS_B0
+        if (not read(Register::PRS_B2, pres, 3)) {
+            // Do not decode a partially read result
+            fail(State::PRES_ERROR);
+            break;
+        }
 
-        float prs_reg =
-            twosComplement((pres_msb << 16) | (pres_mid << 8) | pres_lsb, 24);
+        float prs_reg = twosComplement((pres[0] << 16) | (pres[1] << 8) | pres[2], 24);
         _values.p_raw_scaled =
             prs_reg / getScaleFactorFor(_settings.pressure_precision);
 
@@ -79,13 +148,89 @@ void DPS310::update() {
         float c = _values.t_raw_scaled
             * (_coef.c01
                + _values.p_raw_scaled * (_coef.c11 + _values.p_raw_scaled * _coef.c21));
-        _values.pressure = (a + b + c) / 100.0f;
+        _burst.pressures[_burst.done++] = (a + b + c) / 100.0f;
+
+        // Further samples are compensated with the same temperature
+        if (_burst.done < _burst.length) {
+            set(State::PRES_PENDING);
+            break;
+        }
+        float sum = 0;
+        for (int i = 0; i < _burst.length; ++i) { sum += _burst.pressures[i]; }
+        _values.pressure = sum / _burst.length;
+        // The mean is sampled at the middle of the conversions
+        const uint32_t span = _burst.last_started - _burst.first_started
+            + _pressure_timing.getLearned();
+        _values.timestamp = _burst.first_started + span / 2;
 
+        ++_stats.samples;
+        _failure = Result::SUCCESS;
+        _presence.hit();
+        _rail.off();
+        _energy.completeSample();
+        _latency.add(micros() - _requested_at);
+        _polls.add(_request_polls);
         set(State::AVAILABLE);
         break;
     }
     case State::PRES_ERROR: {
-        set(State::IDLE);
+        escalate(true);
+        break;
+    }
+    case State::ABSENT: {
+        // A switched device is looked for by request(), which powers it
+        if (_rail.isGated() or not _presence.due(millis())) { break; }
+        // An address-only transaction costs the bus least
+        if (not _spi and not _bus->probe(use(_address))) {
+            _presence.backoff();
+            break;
+        }
+        if (reattach() == Result::SUCCESS) {
+            ++_stats.reattaches;
+            _presence.found();
+            _failure = Result::SUCCESS;
+            set(State::IDLE);
+        } else if (_error == Result::FAILED_BUSY) {
+            _presence.retrySoon();
+        } else {
+            _presence.backoff();
+        }
+        break;
+    }
+    case State::POWER_UP: {
+        const uint32_t now = micros();
+        if (not _power_up_timing.due(now)) { break; }
+        // Fails or reports FAILED_BUSY until the calibration is loaded
+        const bool ready = reattach() == Result::SUCCESS;
+        _power_up_timing.observe(now, ready);
+        if (ready) {
+            if (_presence.isAbsent()) {
+                ++_stats.reattaches;
+                _presence.found();
+            }
+            if (not startTemperature()) { fail(State::TEMP_ERROR); }
+        } else if (static_cast<int32_t>(now - _deadline) >= 0) {
+            if (not(_error == Result::FAILED_NOT_RESPONDING)) {
+                setError(Result::FAILED_TIMEOUT);
+            }
+            _failure = _error;
+            giveUp();
+        }
+        break;
+    }
+    case State::RESETTING: {
+        const uint32_t now = micros();
+        if (static_cast<int32_t>(now - _poll_at) < 0) { break; }
+        _poll_at = now + RESET_POLL_INTERVAL * 1000;
+        // The same part comes back; its cached coefficients are kept
+        if (reattach() == Result::SUCCESS) {
+            if (not startTemperature()) { fail(State::TEMP_ERROR); }
+        } else if (not(_error == Result::FAILED_BUSY)) {
+            fail(State::TEMP_ERROR);
+        } else if (static_cast<int32_t>(now - _deadline) >= 0) {
+            setError(Result::FAILED_TIMEOUT);
+            fail(State::TEMP_ERROR);
+        }
         break;
     }
     default: break;
@@ -93,45 +238,269 @@ void DPS310::update() {
 }
 
 void DPS310::end() {
+    _rail.off();
+    // Other devices may still use the bus; it stops with its last user
+    releaseBus();
     if (in(State::WAIT_BEGIN)) { return; }
-    Wire.end();
     set(State::WAIT_BEGIN);
 }
 
-DPS310::Result DPS310::request() {
-    if (not in(State::IDLE)) {
+void DPS310::onSleep() {
+    if (_sleep.asleep) { return; }
+    // Nothing runs before begin(), while absent, or without supply
+    if (in(State::WAIT_SETUP) or in(State::WAIT_BEGIN) or in(State::ABSENT)
+        or not _rail.isOn()) {
+        return;
+    }
+    uint8_t meas_cfg;
+    if (not read(Register::MEAS_CFG, &meas_cfg)) { return; }
+    _sleep.asleep = true;
+    _sleep.mode = static_cast<OperationMode>(meas_cfg & 0x07);
+    if (_sleep.mode == OperationMode::STANDBY) { return; }
+    applyOperationMode(OperationMode::STANDBY);
+}
+
+void DPS310::onWakeup() {
+    if (not _sleep.asleep) { return; }
+    _sleep.asleep = false;
+    switch (_state) {
+    case State::TEMP_BUSY: {
+        // Converting again also keeps the timing and the timestamp true
+        if (not startTemperature()) { fail(State::TEMP_ERROR); }
+        break;
+    }
+    case State::PRES_BUSY: {
+        if (not startPressure()) { fail(State::PRES_ERROR); }
+        break;
+    }
+    default: {
+        // Continuous modes run on; a finished one-shot mode reads back as standby
+        if (use(_sleep.mode) >= use(OperationMode::CONTINUOUS_PRESSURE)) {
+            applyOperationMode(_sleep.mode);
+        }
+        break;
+    }
+    }
+}
+
+DPS310::Result DPS310::request(const uint8_t samples) {
+    if (in(State::ABSENT)) {
+        // A switched device is only powered to look for it when a probe is due
+        if (not _rail.isGated() or not _presence.due(millis())) {
+            setError(Result::FAILED_NOT_RESPONDING);
+            return _error;
+        }
+    } else if (not in(State::IDLE)) {
         setError(Result::FAILED_BUSY);
         return _error;
     }
+    _burst.length = samples < 1 ? 1 : samples > MAX_BURST ? MAX_BURST : samples;
+    _recovery = 0;
+    _failure = Result::SUCCESS;
+    _energy.startSample();
+    _requested_at = micros();
+    _request_polls = 0;
+    if (not _rail.isOn()) {
+        _rail.on();
+        const uint32_t started = _rail.getOnSince();
+        _power_up_timing.start(started);
+        _deadline = started + (SENSOR_READY_TIMEOUT + COEFFICIENT_READY_TIMEOUT) * 1000;
+        set(State::POWER_UP);
+        return Result::SUCCESS;
+    }
     // Starting with a temperature measurement
-    if (not applyOperationMode(OperationMode::ONE_SHOT_TEMPERATURE)) { return _error; }
-    set(State::TEMP_BUSY);
+    if (not startTemperature()) {
+        set(State::IDLE);
+        if (_error == Result::FAILED_NOT_RESPONDING) { miss(); }
+        return _error;
+    }
     return Result::SUCCESS;
 }
 
 DPS310::Result DPS310::read(float* const temperature, float* const pressure) {
-    if (not in(State::AVAILABLE)) {
-        setError(Result::FAILED_BUSY);
-        return _error;
-    }
+    if (not in(State::AVAILABLE)) { return failRead(); }
     *temperature = _values.temperature;
     *pressure = _values.pressure;
     set(State::IDLE);
     return Result::SUCCESS;
 }
 
+DPS310::Result DPS310::read(float* const temperature, float* const pressures,
+                            const uint8_t length) {
+    if (not in(State::AVAILABLE)) { return failRead(); }
+    *temperature = _values.temperature;
+    for (int i = 0; i < _burst.length and i < length; ++i) {
+        pressures[i] = _burst.pressures[i];
+    }
+    set(State::IDLE);
+    return Result::SUCCESS;
+}
+
 DPS310::Result DPS310::softReset() {
     uint8_t meas_cfg;
     if (not write(Register::RESET, 0x09)) { return _error; }
+    uint16_t waited = 0;
     do {
+        if (waited >= SENSOR_READY_TIMEOUT) {
+            setError(Result::FAILED_TIMEOUT);
+            return _error;
+        }
         delay(12);
+        waited += 12;
+        if (not applyInterface()) { return _error; }
         if (not read(Register::MEAS_CFG, &meas_cfg)) { return _error; }
     } while (not hasBitSet(meas_cfg, use(MEAS_CFG::SENSOR_RDY)));
     return Result::SUCCESS;
 }
 
+DPS310::Result DPS310::startReset() {
+    if (not write(Register::RESET, 0x09)) { return _error; }
+    const uint32_t now = micros();
+    _deadline = now + (SENSOR_READY_TIMEOUT + COEFFICIENT_READY_TIMEOUT) * 1000;
+    _poll_at = now + RESET_POLL_INTERVAL * 1000;
+    set(State::RESETTING);
+    return Result::SUCCESS;
+}
+
+void DPS310::setBus(I2CBus& bus) {
+    const bool acquired = _bus_acquired;
+    releaseBus();
+    _bus = &bus;
+    _spi = nullptr;
+    if (acquired) { acquireBus(); }
+}
+
+void DPS310::setBus(SPIBus& bus, const uint8_t device) {
+    const bool acquired = _bus_acquired;
+    releaseBus();
+    _spi = &bus;
+    _spi_device = device;
+    if (acquired) { acquireBus(); }
+}
+
+DPS310::Stats DPS310::getStats() const {
+    Stats stats = _stats;
+    stats.temperature_time = _temperature_timing.getLearned();
+    stats.pressure_time = _pressure_timing.getLearned();
+    stats.temperature_ratio = _temperature_timing.getRatio();
+    stats.pressure_ratio = _pressure_timing.getRatio();
+    stats.rail_on_time = _rail.getTotalOnTime();
+    stats.rail_on_time_last = _rail.getLastOnTime();
+    stats.power_up_time = _rail.isGated() ? _power_up_timing.getLearned() : 0;
+    stats.energy_total = _energy.getTotal();
+    stats.energy_last = _energy.getLast();
+    return stats;
+}
+
+uint32_t DPS310::getWorstCaseLatency(const uint8_t samples) const {
+    const uint32_t temperature = getTimeoutFor(_settings.temperature_precision);
+    const uint32_t pressure = getTimeoutFor(_settings.pressure_precision);
+    const uint32_t window = temperature > pressure ? temperature : pressure;
+    const uint32_t attempt = temperature + pressure * (samples > 1 ? samples : 1);
+    const uint32_t reset = (SENSOR_READY_TIMEOUT + COEFFICIENT_READY_TIMEOUT) * 1000;
+    // A timed-out reset is found at the poll after its deadline
+    const uint32_t restart = reset + RESET_POLL_INTERVAL * 1000;
+    // The first attempt, one more poll, a restarted conversion, then two
+    // resets, each followed by a whole new attempt
+    return (_rail.isGated() ? reset : 0) + attempt + window + window
+        + (restart + attempt) + (BUS_RECOVERY_TIME + restart + attempt);
+}
+
 // MARK: Specific utils (private)
 
+DPS310::Result DPS310::initialize() {
+    if (not softReset()) { return _error; }
+    if (not applyPressureSettings()) { return _error; }
+    if (not applyTemperatureSettings()) { return _error; }
+    if (not applyOperationMode(OperationMode::STANDBY)) { return _error; }
+    return Result::SUCCESS;
+}
+
+DPS310::Result DPS310::reattach() {
+    if (not applyInterface()) { return _error; }
+    if (not(readId() == GENUINE_PRODUCT_ID)) {
+        setError(Result::FAILED_NOT_RESPONDING);
+        return _error;
+    }
+    uint8_t meas_cfg;
+    if (not read(Register::MEAS_CFG, &meas_cfg)) { return _error; }
+    if (not hasBitSet(meas_cfg, use(MEAS_CFG::SENSOR_RDY))
+        or not hasBitSet(meas_cfg, use(MEAS_CFG::COEF_RDY))) {
+        // Still loading its calibration after power-up
+        setError(Result::FAILED_BUSY);
+        return _error;
+    }
+    uint8_t fingerprint[FINGERPRINT_LENGTH];    // C0_MSB onwards
+    if (not read(Register::C0_MSB, fingerprint, FINGERPRINT_LENGTH)) { return _error; }
+    bool known = true;
+    for (int i = 0; i < FINGERPRINT_LENGTH; ++i) {
+        if (fingerprint[i] != _fingerprint[i]) { known = false; }
+    }
+    if (not applyPressureSettings()) { return _error; }
+    if (not applyTemperatureSettings(not known)) { return _error; }
+    if (not applyOperationMode(OperationMode::STANDBY)) { return _error; }
+    // Another part has its own oscillator
+    if (not known) { resetTiming(); }
+    return Result::SUCCESS;
+}
+
+void DPS310::miss() {
+    if (_presence.isAbsent()) {
+        _presence.backoff();
+        set(State::ABSENT);
+        return;
+    }
+    if (not _presence.miss(millis())) { return; }
+    ++_stats.detaches;
+    set(State::ABSENT);
+}
+
+void DPS310::giveUp() {
+    ++_stats.failures;
+    _rail.off();
+    set(State::IDLE);
+    if (_failure == Result::FAILED_NOT_RESPONDING) {
+        miss();
+    } else {
+        _presence.hit();
+    }
+}
+
+void DPS310::escalate(const bool pressure) {
+    if (_recovery >= 4) {
+        giveUp();
+        return;
+    }
+    const State failed = pressure ? State::PRES_ERROR : State::TEMP_ERROR;
+    const Precision precision =
+        pressure ? _settings.pressure_precision : _settings.temperature_precision;
+    ++_stats.recoveries;
+    switch (_recovery++) {
+    case 0: {
+        // Poll again; a status or result read may have been lost on the bus
+        _deadline = micros() + getTimeoutFor(precision);
+        set(pressure ? State::PRES_BUSY : State::TEMP_BUSY);
+        break;
+    }
+    case 1: {
+        // Start the conversion again
+        if (not(pressure ? startPressure() : startTemperature())) { fail(failed); }
+        break;
+    }
+    case 2: {
+        // Reset the device; the request restarts once it is configured again
+        if (not startReset()) { fail(failed); }
+        break;
+    }
+    default: {
+        // Free the I2C bus from a device holding SDA, then as above
+        if (not _spi) { _bus->recover(); }
+        if (not startReset()) { fail(failed); }
+        break;
+    }
+    }
+}
+
 DPS310::Result DPS310::applyPressureSettings() {
     uint8_t prs_cfg, cfg_reg;
     // PRS_CFG
@@ -148,7 +517,7 @@ DPS310::Result DPS310::applyPressureSettings() {
     return Result::SUCCESS;
 }
 
-DPS310::Result DPS310::applyTemperatureSettings() {
+DPS310::Result DPS310::applyTemperatureSettings(const bool reload) {
     uint8_t tmp_cfg, cfg_reg;
     // TMP_CFG
     if (not read(Register::TMP_CFG, &tmp_cfg)) { return _error; }
@@ -163,7 +532,7 @@ DPS310::Result DPS310::applyTemperatureSettings() {
     setBit(&cfg_reg, use(CFG_REG::T_SHIFT),
            use(_settings.temperature_precision) > use(Precision::LOW_8X) ? 1 : 0);
     if (not write(Register::CFG_REG, cfg_reg)) { return _error; }
-    if (not updateCoefficients()) { return _error; }
+    if (not updateCoefficients(reload)) { return _error; }
     return Result::SUCCESS;
 }
 
@@ -175,96 +544,145 @@ DPS310::Result DPS310::applyOperationMode(const OperationMode mode) {
     return Result::SUCCESS;
 }
 
-DPS310::Result DPS310::updateCoefficients() {
+DPS310::Result DPS310::startTemperature() {
+    _burst.done = 0;
+    set(State::TEMP_BUSY);
+    if (not applyOperationMode(OperationMode::ONE_SHOT_TEMPERATURE)) { return _error; }
+    const uint32_t started = micros();
+    _temperature_timing.start(started);
+    _energy.addConversion(CONVERSION_CURRENT, _temperature_timing.getLearned());
+    _deadline = started + getTimeoutFor(_settings.temperature_precision);
+    return Result::SUCCESS;
+}
+
+DPS310::Result DPS310::startPressure() {
+    set(State::PRES_BUSY);
+    if (not applyOperationMode(OperationMode::ONE_SHOT_PRESSURE)) { return _error; }
+    const uint32_t started = micros();
+    _pressure_timing.start(started);
+    _energy.addConversion(CONVERSION_CURRENT, _pressure_timing.getLearned());
+    _deadline = started + getTimeoutFor(_settings.pressure_precision);
+    if (_burst.done == 0) { _burst.first_started = started; }
+    _burst.last_started = started;
+    return Result::SUCCESS;
+}
+
+DPS310::Result DPS310::updateCoefficients(const bool reload) {
     // Set coefficient source
     uint8_t coef_srce, meas_cfg;
     if (not read(Register::COEF_SRCE, &coef_srce)) { return _error; }
     setBit(&coef_srce, use(COEF_SRCE::TMP_COEF_SRCE),
            use(_settings.temperature_source));
     if (not write(Register::COEF_SRCE, coef_srce)) { return _error; }
+    if (not reload) { return Result::SUCCESS; }
     // Wait for ready
+    uint16_t waited = 0;
     do {
+        if (waited++ >= COEFFICIENT_READY_TIMEOUT) {
+            setError(Result::FAILED_TIMEOUT);
+            return _error;
+        }
         delay(1);
         if (not read(Register::MEAS_CFG, &meas_cfg)) { return _error; }
     } while (not hasBitSet(meas_cfg, use(MEAS_CFG::COEF_RDY)));
     // Read coefficients
-    uint8_t c0_msb, c0_lsb_c1_msb, c1_lsb, c00_msb, c00_mid, c00_lsb_c10_msb, c10_mid,
-        c10_lsb, c01_msb, c01_lsb, c11_msb, c11_lsb, c20_msb, c20_lsb, c21_msb, c21_lsb,
-        c30_msb, c30_lsb;
-    if (not(read(Register::C0_MSB, &c0_msb)
-            and read(Register::C0_LSB_C1_MSB, &c0_lsb_c1_msb)
-            and read(Register::C1_LSB, &c1_lsb) and read(Register::C00_MSB, &c00_msb)
-            and read(Register::C00_MID, &c00_mid)
-            and read(Register::C00_LSB_C10_MSB, &c00_lsb_c10_msb)
-            and read(Register::C10_MID, &c10_mid) and read(Register::C10_LSB, &c10_lsb)
-            and read(Register::C01_MSB, &c01_msb) and read(Register::C01_LSB, &c01_lsb)
-            and read(Register::C11_MSB, &c11_msb) and read(Register::C11_LSB, &c11_lsb)
-            and read(Register::C20_MSB, &c20_msb) and read(Register::C20_LSB, &c20_lsb)
-            and read(Register::C21_MSB, &c21_msb) and read(Register::C21_LSB, &c21_lsb)
-            and read(Register::C30_MSB, &c30_msb)
-            and read(Register::C30_LSB, &c30_lsb))) {
-        return _error;
-    }
-    _coef.setC0(c0_msb, c0_lsb_c1_msb);
-    _coef.setC1(c0_lsb_c1_msb, c1_lsb);
-    _coef.setC00(c00_msb, c00_mid, c00_lsb_c10_msb);
-    _coef.setC10(c00_lsb_c10_msb, c10_mid, c10_lsb);
-    _coef.setC01(c01_msb, c01_lsb);
-    _coef.setC11(c11_msb, c11_lsb);
-    _coef.setC11(c11_msb, c11_lsb);
-    _coef.setC20(c20_msb, c20_lsb);
-    _coef.setC21(c21_msb, c21_lsb);
-    _coef.setC30(c30_msb, c30_lsb);
+    uint8_t coef[COEFFICIENT_LENGTH];    // C0_MSB to C30_LSB
+    if (not read(Register::C0_MSB, coef, COEFFICIENT_LENGTH)) { return _error; }
+    _coef.setC0(coef[0], coef[1]);
+    _coef.setC1(coef[1], coef[2]);
+    _coef.setC00(coef[3], coef[4], coef[5]);
+    _coef.setC10(coef[5], coef[6], coef[7]);
+    _coef.setC01(coef[8], coef[9]);
+    _coef.setC11(coef[10], coef[11]);
+    _coef.setC20(coef[12], coef[13]);
+    _coef.setC21(coef[14], coef[15]);
+    _coef.setC30(coef[16], coef[17]);
+    for (int i = 0; i < FINGERPRINT_LENGTH; ++i) { _fingerprint[i] = coef[i]; }
     return Result::SUCCESS;
 }
 
-// MARK: Common I2C utils (private)
-
-DPS310::Result DPS310::read(const Register reg, uint8_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-    } else {
+DPS310::Result DPS310::failRead() {
+    if (in(State::ABSENT)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
-    if (auto&& reader = Wire.get_reader(use(_address), 1)) {
-        reader >> *dst;
-    } else {
-        setError(Result::FAILED_NOT_RESPONDING);
+    if (in(State::IDLE) and _failure != Result::SUCCESS) {
+        // A request given up in update() is reported once
+        setError(_failure);
+        _failure = Result::SUCCESS;
         return _error;
     }
+    setError(Result::FAILED_BUSY);
+    return _error;
+}
+
+DPS310::Result DPS310::applyInterface() {
+    if (not _spi or not _spi->isThreeWire()) { return Result::SUCCESS; }
+    // The other bits of CFG_REG are applied later by the settings
+    uint8_t cfg_reg = 0;
+    setBit(&cfg_reg, use(CFG_REG::SPI_MODE), 1);
+    if (not write(Register::CFG_REG, cfg_reg)) { return _error; }
     return Result::SUCCESS;
 }
 
-DPS310::Result DPS310::read(const Register reg, uint16_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
+// MARK: Common bus utils (private)
+
+bool DPS310::acquireBus() {
+    if (not _bus_acquired) { _bus_acquired = _spi ? _spi->acquire() : _bus->acquire(); }
+    return _bus_acquired;
+}
+
+void DPS310::releaseBus() {
+    if (not _bus_acquired) { return; }
+    if (_spi) {
+        _spi->release();
     } else {
-        setError(Result::FAILED_NOT_RESPONDING);
-        return _error;
+        _bus->release();
     }
-    if (auto&& reader = Wire.get_reader(use(_address), 2)) {
-        uint8_t byte1, byte2;
-        reader >> byte1;
-        reader >> byte2;
-        *dst = (byte1 << 8) | byte2;
+    _bus_acquired = false;
+}
+
+DPS310::Result DPS310::read(const Register reg, uint8_t* const dst, const uint8_t length) {
+    bool done;
+    if (_spi) {
+        const uint8_t command = use(reg) | SPI_READ;
+        done = _spi->transfer(_spi_device, &command, 1, dst, length);
     } else {
+        done = _bus->readRegister(use(_address), use(reg), dst, length, _max_speed);
+        // Address, register, address again, data
+        _energy.addBytes(length + 3);
+    }
+    if (not done) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
     return Result::SUCCESS;
 }
 
+DPS310::Result DPS310::read(const Register reg, uint8_t* const dst) {
+    return read(reg, dst, 1);
+}
+
+DPS310::Result DPS310::read(const Register reg, uint16_t* const dst) {
+    uint8_t bytes[2];
+    if (not read(reg, bytes, 2)) { return _error; }
+    *dst = (bytes[0] << 8) | bytes[1];
+    return Result::SUCCESS;
+}
+
 DPS310::Result DPS310::write(const Register reg, const int src) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-        if (src <= 0xFF) {
-            writer << src;
-        } else {
-            writer << ((src >> 8) & 0xFF);
-            writer << (src & 0xFF);
-        }
+    uint8_t bytes[3] = { use(reg) };
+    uint8_t length = 1;
+    if (src <= 0xFF) {
+        bytes[length++] = src;
     } else {
+        bytes[length++] = (src >> 8) & 0xFF;
+        bytes[length++] = src & 0xFF;
+    }
+    const bool done = _spi ? _spi->transfer(_spi_device, bytes, length, nullptr, 0) :
+                             _bus->write(use(_address), bytes, length, _max_speed);
+    if (not _spi) { _energy.addBytes(length + 1); }
+    if (not done) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
@@ -17,6 +17,14 @@
  */
 #include <TWELITE>
 
+#include "ConversionTimeEstimator.hpp"
+#include "EnergyMeter.hpp"
+#include "Histogram.hpp"
+#include "I2CBus.hpp"
+#include "PowerRail.hpp"
+#include "PresenceMonitor.hpp"
+#include "SPIBus.hpp"
+
 /**
  * @class DPS310
  * @brief Interface for the device.
@@ -258,6 +266,19 @@ public:
         }
     }
 
+    /// Maximum number of pressure samples of one request
+    static const uint8_t MAX_BURST = 16;
+
+    /**
+     * @brief Returns the longest wait for a conversion before it is timed out.
+     *
+     * @param precision The oversampling precision level.
+     * @return Half again the measurement time of `getMeasurementTimeFor()` (us).
+     */
+    static inline uint32_t getTimeoutFor(const Precision precision) {
+        return getMeasurementTimeFor(precision) * 1500;
+    }
+
 private:
     // MARK: Constants (private)
 
@@ -296,6 +317,33 @@ private:
      */
     static const uint8_t GENUINE_PRODUCT_ID = 0x10;
 
+    /// Bit set in the address byte of an SPI read
+    static const uint8_t SPI_READ = 0x80;
+
+    /// Number of coefficient registers, from `C0_MSB` to `C30_LSB`
+    static const uint8_t COEFFICIENT_LENGTH = 18;
+
+    /// Longest wait for `SENSOR_RDY` after a soft reset (ms)
+    static const uint16_t SENSOR_READY_TIMEOUT = 48;
+
+    /// Longest wait for `COEF_RDY` (ms)
+    static const uint16_t COEFFICIENT_READY_TIMEOUT = 40;
+
+    /// Interval of the status polls while a soft reset of the recovery completes (ms)
+    static const uint16_t RESET_POLL_INTERVAL = 4;
+
+    /// Upper bound of the I2C bus recovery (us)
+    static const uint16_t BUS_RECOVERY_TIME = 1000;
+
+    /// Current drawn during a conversion (uA)
+    static const uint16_t CONVERSION_CURRENT = 345;
+
+    /// Typical time from power-on to `COEF_RDY` (ms)
+    static const uint16_t POWER_UP_TIME = 40;
+
+    /// Number of coefficient registers compared to recognise a returning part
+    static const uint8_t FINGERPRINT_LENGTH = 4;
+
 private:
     // MARK: States (private)
 
@@ -313,10 +361,13 @@ private:
      * - `TEMP_BUSY`: A temperature measurement is in progress.
      * - `TEMP_COMPLETE`: Temperature measurement completed successfully.
      * - `TEMP_ERROR`: An error occurred during temperature measurement.
+     * - `PRES_PENDING`: A pressure conversion is to be started.
      * - `PRES_BUSY`: A pressure measurement is in progress.
      * - `PRES_COMPLETE`: Pressure measurement completed successfully.
      * - `PRES_ERROR`: An error occurred during pressure measurement.
      * - `AVAILABLE`: Data is ready to be read.
+     * - `ABSENT`: The device stopped responding and is probed for its return.
+     * - `POWER_UP`: The rail was turned on for a request; waiting for the device.
      */
     enum class State : int {
         WAIT_SETUP,       ///< Waiting for setup to complete.
@@ -325,10 +376,14 @@ private:
         TEMP_BUSY,        ///< Temperature measurement in progress.
         TEMP_COMPLETE,    ///< Temperature measurement successful.
         TEMP_ERROR,       ///< Error during temperature measurement.
+        PRES_PENDING,     ///< Pressure conversion to be started.
         PRES_BUSY,        ///< Pressure measurement in progress.
         PRES_COMPLETE,    ///< Pressure measurement successful.
         PRES_ERROR,       ///< Error during pressure measurement.
-        AVAILABLE         ///< Data is ready for reading.
+        AVAILABLE,        ///< Data is ready for reading.
+        ABSENT,           ///< Device is unplugged; probed for its return.
+        POWER_UP,         ///< Rail turned on; waiting for calibration to load.
+        RESETTING         ///< Soft reset by the recovery; waiting for calibration.
     };
     /**
      * @brief Helper function to retrieve the numeric value of an State enum.
@@ -348,6 +403,19 @@ private:
      */
     inline bool in(const State state) { return _state == state; }
 
+    /**
+     * @brief Enters an error state, keeping the first error of the request.
+     *
+     * Later errors of the recovery, or of calls made meanwhile, do not replace the
+     * cause reported by `read()`.
+     *
+     * @param state The error state to enter.
+     */
+    inline void fail(const State state) {
+        if (_failure == Result::SUCCESS) { _failure = _error; }
+        set(state);
+    }
+
 public:
     // MARK: Results (public)
     /**
@@ -360,6 +428,7 @@ public:
         SUCCESS,                  ///< Operation completed successfully.
         FAILED_NOT_RESPONDING,    ///< Device is not responding.
         FAILED_BUSY,              ///< Device is busy with another operation.
+        FAILED_TIMEOUT,           ///< Device did not complete in time.
         FAILED_UNKNOWN            ///< An unknown error occurred.
     };
 
@@ -388,6 +457,35 @@ public:
      */
     friend Result operator||(Result lhs, Result rhs);
 
+public:
+    // MARK: Statistics (public)
+
+    /**
+     * @brief Counters and learned timing of the device.
+     *
+     * The conversion times are learned from the ready bits (see
+     * `ConversionTimeEstimator`); a ratio below 1 means the part converts faster
+     * than `getMeasurementTimeFor()`.
+     */
+    struct Stats {
+        uint32_t samples;             ///< Completed measurements
+        uint32_t status_polls;        ///< Status reads while a conversion runs
+        uint32_t timeouts;            ///< Conversions not ready in time
+        uint32_t recoveries;          ///< Recovery steps taken
+        uint32_t failures;            ///< Requests given up after all recovery steps
+        uint32_t detaches;            ///< Times the device was found unplugged
+        uint32_t reattaches;          ///< Times the device came back
+        uint32_t rail_on_time;        ///< Total on-time of the power rail (us)
+        uint32_t rail_on_time_last;   ///< Rail on-time of the latest request (us)
+        uint32_t power_up_time;       ///< Learned power-on to ready time (us)
+        uint32_t energy_total;        ///< Modelled energy of all requests (uJ)
+        uint32_t energy_last;         ///< Modelled energy of the latest sample (nJ)
+        uint32_t temperature_time;    ///< Learned temperature conversion time (us)
+        uint32_t pressure_time;       ///< Learned pressure conversion time (us)
+        float temperature_ratio;      ///< Learned / nominal temperature time
+        float pressure_ratio;         ///< Learned / nominal pressure time
+    };
+
 private:
     // MARK: Registers (private)
 
@@ -610,6 +708,21 @@ private:
     /// I2C address of the device
     Address _address;
 
+    /// I2C bus the device is connected to
+    I2CBus* _bus;
+
+    /// `true` while the device holds a reference to the bus
+    bool _bus_acquired;
+
+    /// Fastest I2C speed supported by the device
+    I2CBus::Speed _max_speed;
+
+    /// SPI bus the device is connected to, or `nullptr` when connected via I2C
+    SPIBus* _spi;
+
+    /// Selection of the device on the SPI bus
+    uint8_t _spi_device;
+
     /// Configuration settings for the device
     Settings _settings;
 
@@ -658,8 +771,78 @@ private:
         float temperature;     ///< Latest temperature in °C
         float p_raw_scaled;    ///< Scaled raw pressure data
         float pressure;        ///< Latest pressure in hPa
+        uint32_t timestamp;    ///< Midpoint of the pressure conversion (us)
     } _values;
 
+    /// Pressure samples of the current request
+    struct {
+        uint8_t length;                 ///< Number of samples requested
+        uint8_t done;                   ///< Number of samples converted
+        uint32_t first_started;         ///< Start of the first conversion (us)
+        uint32_t last_started;          ///< Start of the latest conversion (us)
+        float pressures[MAX_BURST];     ///< Compensated samples (hPa)
+    } _burst;
+
+    /// Time the running conversion is timed out (us)
+    uint32_t _deadline;
+
+    /// Time of the next status poll while resetting (us)
+    uint32_t _poll_at;
+
+    /// Recovery steps taken for the current request
+    uint8_t _recovery;
+
+    /// First error of the current request, reported by `read()` if it fails
+    Result _failure;
+
+    /// Raw leading coefficient bytes of the part, to recognise it when it returns
+    uint8_t _fingerprint[FINGERPRINT_LENGTH];
+
+    /// Unplug and return detection
+    PresenceMonitor _presence;
+
+    /// Switched supply of the device
+    PowerRail _rail;
+
+    /// Measurement mode suspended by `onSleep()`
+    struct {
+        bool asleep;           ///< `true` between `onSleep()` and `onWakeup()`
+        OperationMode mode;    ///< Mode the device was in
+    } _sleep;
+
+    /// Learned time from power-on to a configurable device
+    ConversionTimeEstimator _power_up_timing;
+
+    /// Modelled energy of the conversions and the bus traffic
+    EnergyMeter _energy;
+
+    /// Recent longest duration of one step of `update()` (us)
+    uint32_t _step_cost;
+
+    /// Time of the latest `request()` (us)
+    uint32_t _requested_at;
+
+    /// Status reads of the request in progress
+    uint16_t _request_polls;
+
+    /// Time from `request()` to `available()` (us)
+    DiagnosticHistogram<80> _latency;
+
+    /// Status reads per completed request
+    DiagnosticHistogram<24> _polls;
+
+    /// Duration of the `update()` calls that did work (us)
+    DiagnosticHistogram<48> _update_time;
+
+    /// Learned duration of the temperature conversion
+    ConversionTimeEstimator _temperature_timing;
+
+    /// Learned duration of the pressure conversion
+    ConversionTimeEstimator _pressure_timing;
+
+    /// Counters of the device
+    Stats _stats;
+
 public:
     // MARK: Const/Destructor (public)
 
@@ -672,8 +855,13 @@ public:
     DPS310()
         : _state(State::WAIT_SETUP), _error(Result::FAILED_UNKNOWN),
           _error_message { 0 }, _address(Address::PRIMARY),
+          _bus(&I2CBus::getDefault()), _bus_acquired(false),
+          _max_speed(I2CBus::Speed::HIGH_SPEED), _spi(nullptr), _spi_device(0),
           _settings(Settings(Settings::Presets::DEFAULT)),
-          _operation_mode(OperationMode::STANDBY), _coef { 0 }, _values { 0 } {}
+          _operation_mode(OperationMode::STANDBY), _coef { 0 }, _values { 0 },
+          _burst {}, _deadline(0), _poll_at(0), _recovery(0), _failure(Result::SUCCESS),
+          _fingerprint {}, _sleep { false, OperationMode::STANDBY },
+          _step_cost(0), _requested_at(0), _request_polls(0), _stats {} {}
 
     /**
      * @brief Destructor for the device interface.
@@ -713,6 +901,56 @@ public:
      */
     inline void setAddress(const Address address) { _address = address; }
 
+    /**
+     * @brief Retrieves the I2C bus the device is connected to.
+     * @return A reference to the bus.
+     */
+    inline I2CBus& getBus() { return *_bus; }
+
+    /**
+     * @brief Sets the I2C bus the device is connected to.
+     *
+     * The hardware I2C bus on the default pins is used unless another bus is set.
+     * Call before `begin()`; a bus held by a running device is handed over.
+     *
+     * @param bus The bus to use.
+     */
+    void setBus(I2CBus& bus);
+
+    /**
+     * @brief Sets the SPI bus the device is connected to, instead of I2C.
+     *
+     * The device is switched to 3-wire mode when the bus is a 3-wire bus.
+     * Call before `begin()`; a bus held by a running device is handed over.
+     *
+     * @param bus The bus to use.
+     * @param device Selection of the device (chip select pin or controller slot).
+     */
+    void setBus(SPIBus& bus, const uint8_t device);
+
+    /**
+     * @brief Check whether the device is connected via SPI.
+     * @return `true` for SPI; `false` for I2C.
+     */
+    inline bool isSPI() const { return _spi != nullptr; }
+
+    /**
+     * @brief Retrieves the fastest I2C speed used for the device.
+     * @return The speed limit of the device.
+     */
+    inline I2CBus::Speed getMaxSpeed() const { return _max_speed; }
+
+    /**
+     * @brief Sets the fastest I2C speed used for the device.
+     *
+     * The DPS310 supports up to High-speed mode (3.4 MHz). The transactions run at
+     * the fastest speed allowed by both this setting and the bus (see
+     * `I2CBus::setMaxSpeed()`).
+     *
+     * @param speed The speed limit of the device.
+     */
+    inline void setMaxSpeed(const I2CBus::Speed speed) { _max_speed = speed; }
+
     /**
      * @brief Retrieves the current device settings.
      *
@@ -733,6 +971,112 @@ public:
      */
     inline void setSettings(const Settings& settings) { _settings = settings; }
 
+    /**
+     * @brief Sets a pin that switches the supply of the device.
+     *
+     * The driver then turns the rail on only for each request. `begin()` configures
+     * the device once and caches its coefficients; each request then waits only
+     * until the calibration is loaded, applies the settings without a reset and
+     * turns the rail off as soon as the result is read out. Call before `begin()`.
+     *
+     * @param pin Enable pin, or `PowerRail::NO_PIN` for an always-on supply.
+     * @param active_high `true` if the rail is on while the pin is high.
+     */
+    inline void setPowerPin(const uint8_t pin, const bool active_high = true) {
+        _rail.setup(pin, active_high);
+    }
+
+    /**
+     * @brief Retrieves the energy model of the device.
+     *
+     * Each conversion is charged with `CONVERSION_CURRENT` for its learned time, and
+     * each I2C byte with the bus energy of the model; set the supply voltage and the
+     * bus energy of the board through the returned meter. A sample is one request,
+     * from `request()` to `available()`.
+     *
+     * @return A reference to the meter.
+     */
+    inline EnergyMeter& getEnergyMeter() { return _energy; }
+
+    /**
+     * @brief Retrieves the distribution of the time from `request()` to
+     * `available()` (us), of the completed requests.
+     *
+     * Unlike `getWorstCaseLatency()`, this is what the requests took, including the
+     * interval between `update()` calls. Up to about 1.8 s is bucketed.
+     *
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<80>& getLatencyHistogram() const {
+        return _latency;
+    }
+
+    /**
+     * @brief Retrieves the distribution of the status reads per completed request.
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<24>& getPollHistogram() const {
+        return _polls;
+    }
+
+    /**
+     * @brief Retrieves the distribution of the duration of `update()` (us).
+     *
+     * Only the calls that read the device or changed the state are counted, so the
+     * idle calls of the main loop do not hide the expensive ones.
+     *
+     * @return A reference to the histogram; percentiles and buckets only with
+     *     `HISTOGRAM_DIAGNOSTICS`.
+     */
+    inline const DiagnosticHistogram<48>& getUpdateHistogram() const {
+        return _update_time;
+    }
+
+    /**
+     * @brief Retrieves the counters and the learned timing of the device.
+     *
+     * The learned timing restarts from the datasheet values on each `begin()`.
+     *
+     * @return The statistics.
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Clears the counters; the learned timing is kept.
+     */
+    inline void clearStats() {
+        _stats.samples = 0;
+        _stats.status_polls = 0;
+        _stats.timeouts = 0;
+        _stats.recoveries = 0;
+        _stats.failures = 0;
+        _stats.detaches = 0;
+        _stats.reattaches = 0;
+        _rail.clear();
+        _energy.clear();
+        _latency.clear();
+        _polls.clear();
+        _update_time.clear();
+    }
+
+    /**
+     * @brief Retrieves the longest time from `request()` to `available()`.
+     *
+     * A conversion that is not ready in `getTimeoutFor()` is polled once more, then
+     * started again; after that the device is soft reset, and then the I2C bus is
+     * recovered and the device reset again, each time restarting the request. A
+     * request that still fails is given up and reported by `read()`. This bounds
+     * every request, excluding the bus transactions and the interval between
+     * `update()` calls at each step. With a switched supply, the wait for the
+     * device after power-on is added.
+     *
+     * @param samples Number of pressure samples of the request.
+     * @return The worst-case latency with the current settings (us).
+     */
+    uint32_t getWorstCaseLatency(const uint8_t samples = 1) const;
+
 private:
     // MARK: Set/Get (private)
 
@@ -764,6 +1108,9 @@ private:
             snprintf_(_error_message, sizeof(_error_message),
                       "Error: DPS310 is not responding");
             break;
+        case Result::FAILED_TIMEOUT:
+            snprintf_(_error_message, sizeof(_error_message), "Error: DPS310 timed out");
+            break;
         case Result::FAILED_UNKNOWN:
             snprintf_(_error_message, sizeof(_error_message),
                       "Error: Unknown issue with DPS310");
@@ -819,8 +1166,19 @@ public:
      *
      * Updates the device's state and handles ongoing measurement tasks. This function
      * should be called periodically in the main loop to maintain device functionality.
+     *
+     * The work is split into steps of at most one result read or one conversion
+     * start, each a bus transaction or two. A call takes one step; with a budget,
+     * it takes further steps while the recent longest step still fits, and leaves
+     * the rest to the next call. Status polls and recovery steps are only taken as
+     * the first step of a call. A soft reset of the recovery is not waited for
+     * either; the device is polled for it every `RESET_POLL_INTERVAL`.
+     *
+     * @param budget Time the call may take (us); 0 for a single step.
+     * @return `true` if work is left that the next call can do at once; otherwise,
+     *     `false`.
      */
-    void update();
+    bool update(const uint32_t budget = 0);
 
     /**
      * @brief End measurements.
@@ -839,19 +1197,55 @@ public:
      */
     inline bool available() { return in(DPS310::State::AVAILABLE); }
 
+    /**
+     * @brief Check if the device is taken as unplugged.
+     *
+     * After `PresenceMonitor::ABSENT_AFTER` consecutive requests failed with
+     * `FAILED_NOT_RESPONDING`, requests fail at once and `update()` only probes
+     * for the device at a backed-off interval. When it answers again it is
+     * configured without a reset and becomes idle.
+     *
+     * @return `true` if the device is absent; otherwise, `false`.
+     */
+    inline bool isAbsent() { return in(DPS310::State::ABSENT); }
+
+    /**
+     * @brief Check if the device accepts a request.
+     *
+     * A request that is neither available nor pending any more was given up;
+     * `read()` then reports why.
+     *
+     * @return `true` if the device is idle; otherwise, `false`.
+     */
+    inline bool isIdle() { return in(DPS310::State::IDLE); }
+
+    /**
+     * @brief Retrieves when the latest pressure was sampled.
+     *
+     * The pressure conversion is started by the driver, so its midpoint is known
+     * within the bus latency, unlike the time `available()` turns `true`.
+     *
+     * @return The midpoint of the latest pressure conversion (us, as `micros()`).
+     */
+    inline uint32_t getTimestamp() const { return _values.timestamp; }
+
     /**
      * @brief Prepare the device for sleep mode.
      *
-     * Performs any necessary steps to put the device into a low-power state.
+     * Puts the device into `STANDBY`. A running conversion is stopped and a
+     * continuous mode is remembered, so the device draws only its standby current
+     * while the MCU sleeps.
      */
-    inline void onSleep() const {}
+    void onSleep();
 
     /**
      * @brief Wake the device from sleep mode.
      *
-     * Restores the device from a low-power state, preparing it for operation.
+     * Starts the conversion stopped by `onSleep()` again, so a pending request
+     * completes as if there had been no sleep, or restores the continuous mode.
+     * `begin()` is not needed.
      */
-    inline void onWakeup() const {}
+    void onWakeup();
 
     /**
      * @brief Request temperature and pressure measurement.
@@ -859,22 +1253,47 @@ public:
      * Initiates a measurement sequence for both temperature and pressure
      * using the configured settings of the device.
      *
+     * With more than one sample, one temperature conversion is followed by that many
+     * pressure conversions back to back, all compensated with that temperature. The
+     * temperature conversion and the setup are paid once for all samples, which
+     * gives more precision per millisecond than a higher pressure oversampling.
+     *
+     * @param samples Number of pressure conversions, from 1 to `MAX_BURST`.
      * @return `DPS310::Result` indicating the success or failure of the request.
      */
-    Result request();
+    Result request(const uint8_t samples = 1);
 
     /**
      * @brief Read temperature and pressure data after a measurement request.
      *
      * Retrieves the temperature and pressure data measured by the device.
-     * Ensure `request()` has been called before using this method.
+     * Ensure `request()` has been called before using this method. A request given
+     * up in `update()` is reported once here, with the error that started its
+     * recovery.
      *
      * @param temperature Pointer to store the temperature value (°C).
-     * @param pressure Pointer to store the pressure value (hPa).
+     * @param pressure Pointer to store the pressure value, the mean of the samples
+     *     (hPa).
      * @return `DPS310::Result` indicating the success or failure of the read operation.
      */
     Result read(float* const temperature, float* const pressure);
 
+    /**
+     * @brief Read the temperature and each pressure sample of a measurement request.
+     *
+     * @param temperature Pointer to store the temperature value (°C).
+     * @param pressures Array to store the pressure samples, oldest first (hPa).
+     * @param length Number of elements of `pressures`; further samples are dropped.
+     * @return `DPS310::Result` indicating the success or failure of the read operation.
+     */
+    Result read(float* const temperature, float* const pressures, const uint8_t length);
+
+    /**
+     * @brief Retrieves the number of pressure samples of the latest result.
+     * @return The number of samples given to `request()`.
+     */
+    inline uint8_t getSampleCount() const { return _burst.length; }
+
     /**
      * @brief Calculate altitude based on measured pressure and sea-level pressure.
      *
@@ -898,6 +1317,12 @@ public:
      */
     Result softReset();
 
+    /**
+     * @brief Start a soft reset of the recovery, which `update()` polls to its end.
+     * @return `DPS310::Result` indicating the success or failure of the operation.
+     */
+    Result startReset();
+
     /**
      * @brief Read the production and revision ID of the device.
      *
@@ -916,6 +1341,69 @@ public:
 private:
     // MARK: Specific utils (private)
 
+    /**
+     * @brief Reset the device and apply the settings.
+     * @return `DPS310::Result` indicating the success or failure of the operation.
+     */
+    Result initialize();
+
+    /**
+     * @brief Take one step of `update()`.
+     */
+    void step();
+
+    /**
+     * @brief Check whether a step can be taken without waiting for the device.
+     * @return `true` if a result is to be read or a conversion started.
+     */
+    inline bool hasWork() {
+        return in(State::TEMP_COMPLETE) or in(State::PRES_PENDING)
+            or in(State::PRES_COMPLETE);
+    }
+
+    /**
+     * @brief Restart the learned conversion times from the datasheet times.
+     */
+    inline void resetTiming() {
+        _temperature_timing.reset(
+            getMeasurementTimeFor(_settings.temperature_precision) * 1000);
+        _pressure_timing.reset(getMeasurementTimeFor(_settings.pressure_precision)
+                               * 1000);
+    }
+
+    /**
+     * @brief Configure a device that answered again after being absent.
+     *
+     * A replugged part has just powered up, so it is not reset; the settings are
+     * applied once its calibration is loaded. If its leading coefficient bytes
+     * match the cached fingerprint, the cached coefficients and learned conversion
+     * times are kept; otherwise they are read and learned again.
+     *
+     * @return `DPS310::Result` indicating the success or failure of the operation;
+     *     `FAILED_BUSY` while the device is still starting up.
+     */
+    Result reattach();
+
+    /**
+     * @brief Count a request lost to an unresponsive device, and detach it after
+     * enough of them.
+     *
+     * A failed power-up attempt while absent only backs off the next attempt.
+     */
+    void miss();
+
+    /**
+     * @brief Give up the current request; `read()` reports the cause.
+     */
+    void giveUp();
+
+    /**
+     * @brief Take the next recovery step for a failed or late conversion.
+     *
+     * @param pressure `true` for the pressure conversion; `false` for temperature.
+     */
+    void escalate(const bool pressure);
+
     /**
      * @brief Apply saved pressure configurations from settings.
      *
@@ -932,9 +1420,10 @@ private:
      * Updates the device's temperature measurement settings based on the
      * current configuration stored in the `Settings` structure.
      *
+     * @param reload `false` to keep the coefficients read before.
      * @return `DPS310::Result` indicating the success or failure of the operation.
      */
-    Result applyTemperatureSettings();
+    Result applyTemperatureSettings(const bool reload = true);
 
     /**
      * @brief Apply the given operation mode.
@@ -946,21 +1435,77 @@ private:
      */
     Result applyOperationMode(const OperationMode mode);
 
+    /**
+     * @brief Start the temperature conversion of the request.
+     * @return `DPS310::Result` indicating the success or failure of the operation.
+     */
+    Result startTemperature();
+
+    /**
+     * @brief Start the next pressure conversion of the request.
+     * @return `DPS310::Result` indicating the success or failure of the operation.
+     */
+    Result startPressure();
+
     /**
      * @brief Read and update coefficient values.
      *
      * Reads the calibration coefficients from the device and updates
      * the internal data used for temperature and pressure compensation.
      *
+     * @param reload `false` to only select the temperature coefficient source,
+     *     keeping the coefficients read before; `COEF_RDY` must already be set.
+     * @return `DPS310::Result` indicating the success or failure of the operation.
+     */
+    Result updateCoefficients(const bool reload = true);
+
+    /**
+     * @brief Report why no result can be read.
+     *
+     * @return `FAILED_NOT_RESPONDING` while absent; the first error of a request
+     *     given up in `update()`, once; otherwise, `FAILED_BUSY`.
+     */
+    Result failRead();
+
+    /**
+     * @brief Apply the SPI wiring to the device.
+     *
+     * Sets the 3-wire mode on a 3-wire SPI bus; the device resets to 4-wire mode
+     * and cannot answer until this is written. Does nothing on other buses.
+     *
      * @return `DPS310::Result` indicating the success or failure of the operation.
      */
-    Result updateCoefficients();
+    Result applyInterface();
 
 private:
-    // MARK: Common I2C utils (private)
+    // MARK: Common bus utils (private)
+
+    /**
+     * @brief Acquire the bus the device is connected to.
+     * @return `true` if the device holds the bus; otherwise, `false`.
+     */
+    bool acquireBus();
+
+    /**
+     * @brief Release the bus the device is connected to, if held.
+     */
+    void releaseBus();
+
+    /**
+     * @brief Read consecutive registers in one transaction.
+     *
+     * The device increments the register address after each byte, so a result or
+     * the coefficient block is read at once over I2C or SPI.
+     *
+     * @param reg First register address to read from.
+     * @param dst Destination of the data.
+     * @param length Number of registers to read.
+     * @return A `DPS310::Result` indicating success or failure of the read operation.
+     */
+    Result read(const Register reg, uint8_t* const dst, const uint8_t length);
 
     /**
-     * @brief Read 8-bit data via I2C.
+     * @brief Read 8-bit data.
      *
      * Reads a single byte of data from the specified register address.
      *
@@ -971,7 +1516,7 @@ private:
     Result read(const Register reg, uint8_t* const dst);
 
     /**
-     * @brief Read 16-bit data via I2C.
+     * @brief Read 16-bit data.
      *
      * Reads 2 bytes of data from the specified register address.
      *
@@ -982,7 +1527,7 @@ private:
     Result read(const Register reg, uint16_t* const dst);
 
     /**
-     * @brief Write 8-bit or 16-bit data via I2C.
+     * @brief Write 8-bit or 16-bit data.
      *
      * Writes a single or two byte(s) of data to the specified register address.
      *
@@ -0,0 +1,268 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   DPS310MockSPIBus.hpp
+ * @brief  SPI bus with a simulated DPS310 register file, for running `DPS310` on a
+ *         host PC.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Host builds only: the timing follows `micros()` of the host stand-in of the MWX
+ * library.
+ */
+#include "SPIBus.hpp"
+
+/**
+ * @class DPS310MockSPIBus
+ * @brief SPI bus with one simulated DPS310 on it, answering at register level.
+ *
+ * Stands in for the bus and the sensor when checking the SPI transport of `DPS310`
+ * on a host:
+ * - The first byte of a selection is the register address, with bit 7 set for a
+ *   read; the following bytes are written or read with auto-increment, so a burst
+ *   read returns consecutive registers.
+ * - The part starts in 4-wire mode. On a 3-wire bus it cannot reply until
+ *   `CFG_REG.SPI_MODE` is set, and on a 4-wire bus it cannot reply while that bit
+ *   is set; such a reply reads as `0xFF`, the idle level of the data line. A soft
+ *   reset clears the bit again.
+ * - A one-shot conversion sets its ready bit `conversion_time` after it is
+ *   started; the results are the raw values set with `setTemperatureRaw()` and
+ *   `setPressureRaw()`.
+ * - After a soft reset, `SENSOR_RDY` and `COEF_RDY` are clear for `RESET_TIME`.
+ *
+ * Counts selections and bytes, so the transactions per sample can be reported.
+ */
+class DPS310MockSPIBus : public SPIBus {
+public:
+    // MARK: Constants (public)
+
+    /// Number of registers, up to `COEF_SRCE`
+    static const uint8_t REGISTERS = 0x29;
+
+    /// Time from a soft reset to `SENSOR_RDY` and `COEF_RDY` (us)
+    static const uint32_t RESET_TIME = 12000;
+
+private:
+    // MARK: Constants (private)
+
+    /// Register addresses and bits used by the simulation
+    static const uint8_t PRS_B2 = 0x00;
+    static const uint8_t TMP_B2 = 0x03;
+    static const uint8_t MEAS_CFG = 0x08;
+    static const uint8_t CFG_REG = 0x09;
+    static const uint8_t RESET = 0x0C;
+    static const uint8_t PRODUCT_ID = 0x0D;
+    static const uint8_t C0_MSB = 0x10;
+    static const uint8_t COEF_RDY = 0x80;
+    static const uint8_t SENSOR_RDY = 0x40;
+    static const uint8_t TMP_RDY = 0x20;
+    static const uint8_t PRS_RDY = 0x10;
+    static const uint8_t SPI_MODE = 0x01;
+
+private:
+    // MARK: Variables (private)
+
+    /// `true` if MOSI and MISO share one line
+    bool _three_wire;
+
+    /// Register file
+    uint8_t _registers[REGISTERS];
+
+    /// Register of the next byte of the selection
+    uint8_t _pointer;
+
+    /// `true` until the address byte of the selection is received
+    bool _header;
+
+    /// `true` if the selection reads
+    bool _reading;
+
+    /// Conversion time (us)
+    uint32_t _conversion_time;
+
+    /// Time the running conversion completes (us)
+    uint32_t _ready_at;
+
+    /// Time the part is ready after a soft reset (us)
+    uint32_t _reset_until;
+
+    /// Raw results returned by the conversions (24-bit two's complement)
+    int32_t _temperature_raw;
+    int32_t _pressure_raw;
+
+public:
+    /// Selections since construction
+    uint32_t transaction_count;
+
+    /// Bytes clocked out by the host since construction, address bytes included
+    uint32_t bytes_sent;
+
+    /// Bytes clocked in by the host since construction
+    uint32_t bytes_received;
+
+    /// Soft resets since construction
+    uint32_t reset_count;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     *
+     * The coefficient registers hold a fixed pattern; overwrite them with
+     * `setRegister()` for meaningful results.
+     *
+     * @param three_wire `true` for a 3-wire bus; `false` for a 4-wire bus.
+     * @param conversion_time Time of one conversion (us).
+     */
+    DPS310MockSPIBus(const bool three_wire = false,
+                     const uint32_t conversion_time = 3600)
+        : _three_wire(three_wire), _registers {}, _pointer(0), _header(true),
+          _reading(false), _conversion_time(conversion_time), _ready_at(0),
+          _reset_until(0), _temperature_raw(0), _pressure_raw(0), transaction_count(0),
+          bytes_sent(0), bytes_received(0), reset_count(0) {
+        _registers[PRODUCT_ID] = 0x10;
+        _registers[MEAS_CFG] = COEF_RDY | SENSOR_RDY;
+        for (uint8_t i = 0; i < 18; ++i) { _registers[C0_MSB + i] = 0x11 * (i + 1); }
+    }
+
+public:
+    // MARK: Interfaces (public)
+
+    inline bool isThreeWire() const override { return _three_wire; }
+
+    /// Sets the raw temperature result of the following conversions.
+    inline void setTemperatureRaw(const int32_t raw) { _temperature_raw = raw; }
+
+    /// Sets the raw pressure result of the following conversions.
+    inline void setPressureRaw(const int32_t raw) { _pressure_raw = raw; }
+
+    /// Writes a register directly, e.g. a coefficient.
+    inline void setRegister(const uint8_t reg, const uint8_t value) {
+        if (reg < REGISTERS) { _registers[reg] = value; }
+    }
+
+    /// Reads a register directly, without the side effects of a bus read.
+    inline uint8_t getRegister(const uint8_t reg) const {
+        return reg < REGISTERS ? _registers[reg] : 0;
+    }
+
+    /// `true` while the part replies on the line the bus reads.
+    inline bool isAnswering() const {
+        return ((_registers[CFG_REG] & SPI_MODE) != 0) == _three_wire;
+    }
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    inline bool onBegin() override { return true; }
+    inline void onEnd() override {}
+
+    bool select(const uint8_t) override {
+        ++transaction_count;
+        _header = true;
+        _reading = false;
+        return true;
+    }
+
+    inline void deselect() override {}
+
+    void send(const uint8_t* const src, const uint8_t length) override {
+        for (uint8_t i = 0; i < length; ++i) {
+            ++bytes_sent;
+            if (_header) {
+                _pointer = src[i] & 0x7F;
+                _reading = (src[i] & 0x80) != 0;
+                _header = false;
+                continue;
+            }
+            // A write after a read address is ignored by the part
+            if (not _reading) { store(_pointer++, src[i]); }
+        }
+    }
+
+    void receive(uint8_t* const dst, const uint8_t length) override {
+        update();
+        for (uint8_t i = 0; i < length; ++i) {
+            ++bytes_received;
+            dst[i] = isAnswering() and _reading ? load(_pointer) : 0xFF;
+            ++_pointer;
+        }
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Bring the ready bits and results up to date with `micros()`.
+     */
+    void update() {
+        const uint32_t now = micros();
+        uint8_t& meas_cfg = _registers[MEAS_CFG];
+        if (static_cast<int32_t>(now - _reset_until) >= 0) {
+            meas_cfg |= COEF_RDY | SENSOR_RDY;
+        }
+        const uint8_t mode = meas_cfg & 0x07;
+        if ((mode != 1 and mode != 2) or static_cast<int32_t>(now - _ready_at) < 0) {
+            return;
+        }
+        // Mode 1 is a pressure conversion, mode 2 a temperature conversion
+        const int32_t raw = mode == 1 ? _pressure_raw : _temperature_raw;
+        const uint8_t base = mode == 1 ? PRS_B2 : TMP_B2;
+        _registers[base] = (raw >> 16) & 0xFF;
+        _registers[base + 1] = (raw >> 8) & 0xFF;
+        _registers[base + 2] = raw & 0xFF;
+        // A one-shot conversion returns to standby
+        meas_cfg = (meas_cfg & 0xF8) | (mode == 1 ? PRS_RDY : TMP_RDY);
+    }
+
+    /**
+     * @brief Read one register as the part would.
+     * @param reg The register.
+     * @return Its value; `0` beyond the register file.
+     */
+    uint8_t load(const uint8_t reg) const {
+        return reg < REGISTERS ? _registers[reg] : 0;
+    }
+
+    /**
+     * @brief Write one register as the part would.
+     * @param reg The register.
+     * @param value The value.
+     */
+    void store(const uint8_t reg, const uint8_t value) {
+        if (reg >= REGISTERS) { return; }
+        switch (reg) {
+        case MEAS_CFG: {
+            // Only the mode bits are writable
+            const uint8_t mode = value & 0x07;
+            uint8_t& meas_cfg = _registers[MEAS_CFG];
+            meas_cfg = (meas_cfg & (COEF_RDY | SENSOR_RDY)) | mode;
+            if (mode == 1 or mode == 2) { _ready_at = micros() + _conversion_time; }
+            break;
+        }
+        case RESET: {
+            if ((value & 0x0F) != 0x09) { break; }
+            ++reset_count;
+            // Back to 4-wire mode and standby; the coefficients are kept
+            for (uint8_t r = PRS_B2; r < C0_MSB; ++r) {
+                if (r != PRODUCT_ID) { _registers[r] = 0; }
+            }
+            _reset_until = micros() + RESET_TIME;
+            break;
+        }
+        case PRODUCT_ID: break;
+        default: {
+            _registers[reg] = value;
+            break;
+        }
+        }
+    }
+};
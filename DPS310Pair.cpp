@@ -0,0 +1,153 @@
+// -*- coding:utf-8-unix -*-
+
+#include "DPS310Pair.hpp"
+
+// MARK: Interfaces (public)
+
+void DPS310Pair::setup(const Fusion fusion, const uint16_t period) {
+    _fusion = fusion;
+    if (period > 0) {
+        _period = period;
+    } else {
+        const DPS310::Settings& settings = _sensors[0]->getSettings();
+        // One temperature and one pressure conversion, plus a poll interval
+        _period = DPS310::getMeasurementTimeFor(settings.temperature_precision)
+            + DPS310::getMeasurementTimeFor(settings.pressure_precision) + 2;
+    }
+    set(State::WAIT_BEGIN);
+}
+
+void DPS310Pair::begin() {
+    if (not in(State::WAIT_BEGIN)) { end(); }
+    for (int i = 0; i < SENSORS; ++i) { _sensors[i]->begin(); }
+    const uint32_t now = millis();
+    _next_request[0] = now;
+    _next_request[1] = now + _period / 2;
+    _fresh = 0;
+    _seen = 0;
+    _pending = 0;
+    _stale = 0;
+    for (int i = 0; i < SENSORS; ++i) { _errors[i] = DPS310::Result::SUCCESS; }
+    _failure = DPS310::Result::SUCCESS;
+    _offset_valid = false;
+    set(State::RUNNING);
+}
+
+void DPS310Pair::update() {
+    if (in(State::WAIT_SETUP) or in(State::WAIT_BEGIN)) { return; }
+    const uint32_t now = millis();
+    for (int i = 0; i < SENSORS; ++i) {
+        DPS310& sensor = *_sensors[i];
+        sensor.update();
+        // Idle or absent while pending, the sensor gave the request up; read()
+        // says why
+        const bool given_up =
+            (_pending >> i) & 1 and (sensor.isIdle() or sensor.isAbsent());
+        if (sensor.available() or given_up) {
+            _pending &= ~(1 << i);
+            float temperature, pressure;
+            const DPS310::Result result = sensor.read(&temperature, &pressure);
+            if (result == DPS310::Result::SUCCESS) {
+                fuse(i, temperature, pressure);
+            } else {
+                fault(i, result);
+            }
+        }
+        if (static_cast<int32_t>(now - _next_request[i]) < 0) { continue; }
+        const DPS310::Result result = sensor.request();
+        if (result != DPS310::Result::FAILED_BUSY) {
+            // Absent, or a failed request is not retried before the next cycle
+            if (result == DPS310::Result::SUCCESS) {
+                _pending |= 1 << i;
+            } else {
+                fault(i, result);
+            }
+            _next_request[i] += _period;
+            // Resynchronize after a long stall instead of catching up
+            if (static_cast<int32_t>(now - _next_request[i]) >= 0) {
+                _next_request[i] = now + _period;
+            }
+        }
+    }
+}
+
+void DPS310Pair::end() {
+    for (int i = 0; i < SENSORS; ++i) { _sensors[i]->end(); }
+    if (in(State::WAIT_SETUP)) { return; }
+    set(State::WAIT_BEGIN);
+}
+
+DPS310::Result DPS310Pair::read(float* const temperature, float* const pressure) {
+    if (not in(State::AVAILABLE)) {
+        if (_failure == DPS310::Result::SUCCESS) { return DPS310::Result::FAILED_BUSY; }
+        // A sensor error is reported once
+        const DPS310::Result failure = _failure;
+        _failure = DPS310::Result::SUCCESS;
+        return failure;
+    }
+    *temperature = _values.temperature;
+    *pressure = _values.pressure;
+    set(State::RUNNING);
+    return DPS310::Result::SUCCESS;
+}
+
+// MARK: Specific utils (private)
+
+void DPS310Pair::fuse(const int index, const float temperature, const float pressure) {
+    _latest[index].temperature = temperature;
+    _latest[index].pressure = pressure;
+    _fresh |= 1 << index;
+    _seen |= 1 << index;
+    _stale &= ~(1 << index);
+    _errors[index] = DPS310::Result::SUCCESS;
+
+    if (_seen == 0b11) {
+        // Track the offset between the sensors from neighbouring results
+        const float difference = _latest[1].pressure - _latest[0].pressure;
+        _offset = _offset_valid ? _offset + (difference - _offset) / 16 : difference;
+        _offset_valid = true;
+    }
+
+    switch (_fusion) {
+    case Fusion::MEAN:
+    case Fusion::DIFFERENTIAL: {
+        if (_fusion == Fusion::MEAN and _stale != 0) {
+            // The other sensor is stale; the mean lies half the offset away
+            const float half = _offset_valid ? _offset / 2 : 0.0f;
+            _values.temperature = temperature;
+            _values.pressure = index == 0 ? pressure + half : pressure - half;
+            _values.sources = 1 << index;
+            _fresh = 0;
+            break;
+        }
+        if ((_fresh & 0b11) != 0b11) { return; }
+        _values.temperature = (_latest[0].temperature + _latest[1].temperature) / 2;
+        _values.pressure = _fusion == Fusion::MEAN ?
+            (_latest[0].pressure + _latest[1].pressure) / 2 :
+            _latest[0].pressure - _latest[1].pressure;
+        _values.sources = 0b11;
+        _fresh = 0;
+        break;
+    }
+    case Fusion::INTERLEAVED: {
+        if (index == 1 and not _offset_valid) { return; }
+        _values.temperature = temperature;
+        _values.pressure = index == 0 ? pressure : pressure - _offset;
+        _values.sources = 1 << index;
+        _fresh = 0;
+        break;
+    }
+    default: return;
+    }
+    set(State::AVAILABLE);
+}
+
+void DPS310Pair::fault(const int index, const DPS310::Result error) {
+    // Repeated failures of a stale sensor were reported already
+    if (not ((_stale >> index) & 1) and _failure == DPS310::Result::SUCCESS) {
+        _failure = error;
+    }
+    _stale |= 1 << index;
+    _errors[index] = error;
+    _fresh &= ~(1 << index);
+}
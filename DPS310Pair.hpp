@@ -0,0 +1,260 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   DPS310Pair.hpp
+ * @brief  Staggered operation of two DPS310 sensors with fused results.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "DPS310.hpp"
+
+/**
+ * @class DPS310Pair
+ * @brief Coordinator running two DPS310 sensors half a cycle apart.
+ *
+ * Each sensor runs its own temperature and pressure cycle; the second sensor is
+ * started half a cycle after the first, so one sensor converts while the other is
+ * read out and the bus never waits on both at once. Each sensor is restarted on a
+ * fixed schedule, which keeps the offset between them from drifting.
+ *
+ * The results are fused according to `Fusion`:
+ * - `MEAN`: one result per cycle, the mean of both sensors (√2 lower noise).
+ * - `INTERLEAVED`: one result per sensor result (twice the rate); the second sensor
+ *   is corrected by the tracked offset between the sensors so the series does not
+ *   alternate between two levels.
+ * - `DIFFERENTIAL`: one result per cycle, the first sensor minus the second.
+ *
+ * A request given up by a sensor, or a sensor taken as absent, marks that sensor
+ * stale until it delivers again, and its error is reported once by `read()`. While
+ * one sensor is stale, `MEAN` falls back to the other one, shifted by half the
+ * tracked offset to stay on the level of the mean; `getSources()` tells which
+ * sensors a result came from. `DIFFERENTIAL` has no fallback and stops until both
+ * sensors deliver.
+ *
+ * The sensors are configured and set up by the application as usual (typically at
+ * `Address::PRIMARY` and `Address::SECONDARY` on one bus), then handed over.
+ */
+class DPS310Pair {
+public:
+    // MARK: Settings (public)
+
+    /**
+     * @brief Enum class for the ways to combine the two sensors.
+     */
+    enum class Fusion : uint8_t {
+        MEAN,           ///< Mean of both sensors, once per cycle
+        INTERLEAVED,    ///< Every sensor result, offset-corrected, twice per cycle
+        DIFFERENTIAL    ///< First sensor minus second sensor, once per cycle
+    };
+
+    /// Number of sensors in a pair
+    static const int SENSORS = 2;
+
+private:
+    // MARK: States (private)
+
+    /**
+     * @brief Enumeration of internal states for the pair.
+     */
+    enum class State : int {
+        WAIT_SETUP,    ///< Waiting for setup to complete.
+        WAIT_BEGIN,    ///< Waiting for the begin signal.
+        RUNNING,       ///< Both sensors are measuring.
+        AVAILABLE      ///< A fused result is ready to be read.
+    };
+
+    /**
+     * @brief Sets the state of the pair.
+     * @param state The new state.
+     */
+    inline void set(const State state) { _state = state; }
+
+    /**
+     * @brief Checks if the pair is in a specific state.
+     * @param state The state to check.
+     * @return `true` if the pair is in the given state; otherwise, `false`.
+     */
+    inline bool in(const State state) { return _state == state; }
+
+private:
+    // MARK: Variables (private)
+
+    /// Current state of the pair
+    State _state;
+
+    /// The sensors; the first one defines the reference level
+    DPS310* _sensors[SENSORS];
+
+    /// How the results are combined
+    Fusion _fusion;
+
+    /// Cycle period of each sensor (ms)
+    uint16_t _period;
+
+    /// Time each sensor is requested next (ms)
+    uint32_t _next_request[SENSORS];
+
+    /// Latest result per sensor
+    struct {
+        float temperature;    ///< Temperature (°C)
+        float pressure;       ///< Pressure (hPa)
+    } _latest[SENSORS];
+
+    /// Bit per sensor set when its latest result has not been fused yet
+    uint8_t _fresh;
+
+    /// Bit per sensor set once it has produced a result
+    uint8_t _seen;
+
+    /// Bit per sensor set while its request is running
+    uint8_t _pending;
+
+    /// Bit per sensor set while its latest request failed
+    uint8_t _stale;
+
+    /// Error of the latest failed request per sensor
+    DPS310::Result _errors[SENSORS];
+
+    /// First sensor error not reported by `read()` yet
+    DPS310::Result _failure;
+
+    /// Tracked pressure of the second sensor minus the first (hPa)
+    float _offset;
+
+    /// `true` once `_offset` holds a value
+    bool _offset_valid;
+
+    /// Fused result
+    struct {
+        float temperature;    ///< Temperature (°C)
+        float pressure;       ///< Pressure or pressure difference (hPa)
+        uint8_t sources;      ///< Bit per sensor the result came from
+    } _values;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the pair.
+     *
+     * @param first The sensor that defines the reference level.
+     * @param second The other sensor.
+     */
+    DPS310Pair(DPS310& first, DPS310& second)
+        : _state(State::WAIT_SETUP), _sensors { &first, &second },
+          _fusion(Fusion::MEAN), _period(0), _next_request { 0 }, _latest {}, _fresh(0),
+          _seen(0), _pending(0), _stale(0),
+          _errors { DPS310::Result::SUCCESS, DPS310::Result::SUCCESS },
+          _failure(DPS310::Result::SUCCESS), _offset(0), _offset_valid(false),
+          _values {} {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Setup the pair.
+     *
+     * @param fusion How the results are combined.
+     * @param period Cycle period of each sensor (ms); 0 uses the shortest cycle the
+     *     settings of the first sensor allow.
+     */
+    void setup(const Fusion fusion = Fusion::MEAN, const uint16_t period = 0);
+
+    /**
+     * @brief Begin both sensors and start the staggered cycles.
+     */
+    void begin();
+
+    /**
+     * @brief Update both sensors, restart them on schedule and fuse their results.
+     *
+     * Call periodically in the main loop.
+     */
+    void update();
+
+    /**
+     * @brief End both sensors.
+     */
+    void end();
+
+    /**
+     * @brief Check if a fused result is available for reading.
+     * @return `true` if a result is available; otherwise, `false`.
+     */
+    inline bool available() { return in(State::AVAILABLE); }
+
+    /**
+     * @brief Read the fused result.
+     *
+     * @param temperature Pointer to store the mean temperature (°C).
+     * @param pressure Pointer to store the fused pressure, or the pressure
+     *     difference for `Fusion::DIFFERENTIAL` (hPa).
+     * @return `DPS310::Result` indicating the success or failure of the read
+     *     operation; without a result, the first sensor error not reported yet,
+     *     once.
+     */
+    DPS310::Result read(float* const temperature, float* const pressure);
+
+    /**
+     * @brief Retrieves the cycle period of each sensor.
+     * @return The period (ms); results arrive at twice this rate when interleaved.
+     */
+    inline uint16_t getPeriod() const { return _period; }
+
+    /**
+     * @brief Retrieves the tracked pressure offset between the sensors.
+     * @return Pressure of the second sensor minus the first (hPa).
+     */
+    inline float getOffset() const { return _offset; }
+
+    /**
+     * @brief Retrieves the sensors the latest result came from.
+     * @return Bit 0 for the first sensor and bit 1 for the second; one bit only
+     *     for a fallback result.
+     */
+    inline uint8_t getSources() const { return _values.sources; }
+
+    /**
+     * @brief Retrieves the sensors whose latest request failed.
+     * @return Bit 0 for the first sensor and bit 1 for the second.
+     */
+    inline uint8_t getStale() const { return _stale; }
+
+    /**
+     * @brief Retrieves why the latest request of a sensor failed.
+     * @param index Index of the sensor.
+     * @return The error; `SUCCESS` unless the sensor is stale.
+     */
+    inline DPS310::Result getError(const int index) const { return _errors[index]; }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Store a sensor result and produce a fused result if one is due.
+     *
+     * @param index Index of the sensor.
+     * @param temperature Temperature of the sensor (°C).
+     * @param pressure Pressure of the sensor (hPa).
+     */
+    void fuse(const int index, const float temperature, const float pressure);
+
+    /**
+     * @brief Mark a sensor stale with the error of its failed request.
+     *
+     * @param index Index of the sensor.
+     * @param error The error.
+     */
+    void fault(const int index, const DPS310::Result error);
+};
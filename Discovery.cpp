@@ -0,0 +1,130 @@
+// -*- coding:utf-8-unix -*-
+
+#include "Discovery.hpp"
+
+// MARK: Interfaces (public)
+
+void Discovery::setup(const DPS310::Settings& dps310_settings,
+                      const ADS1x1x::DeviceType ads1x1x_type,
+                      const ADS1x1x::Settings& ads1x1x_settings) {
+    _dps310_settings = dps310_settings;
+    _ads1x1x_type = ads1x1x_type;
+    _ads1x1x_settings = ads1x1x_settings;
+    set(State::WAIT_BEGIN);
+}
+
+void Discovery::begin() {
+    if (not in(State::WAIT_BEGIN)) { end(); }
+    // Keep the bus running between the scan and the drivers
+    if (not _bus.acquire()) { return; }
+    scan();
+    for (int i = 0; i < _dps310_count; ++i) {
+        DPS310& sensor = _dps310[i];
+        sensor.setBus(_bus);
+        sensor.setup(sensor.getAddress(), _dps310_settings);
+        sensor.begin();
+    }
+    for (int i = 0; i < _ads1x1x_count; ++i) {
+        ADS1x1x& adc = _ads1x1x[i];
+        adc.setBus(_bus);
+        adc.setup(adc.getAddress(), _ads1x1x_type, _ads1x1x_settings);
+        adc.begin();
+    }
+    _bus.release();
+    set(State::RUNNING);
+}
+
+bool Discovery::update(const uint32_t budget) {
+    if (not in(State::RUNNING)) { return false; }
+    const int count = _dps310_count + _ads1x1x_count;
+    const uint32_t started = micros();
+    bool pending = false;
+    for (int n = 0; n < count; ++n) {
+        const int i = (_next + n) % count;
+        uint32_t left = 0;
+        if (budget > 0) {
+            const uint32_t elapsed = micros() - started;
+            if (elapsed >= budget) {
+                // Start here next time, so no driver is always left out
+                _next = i;
+                return true;
+            }
+            left = budget - elapsed;
+        }
+        const bool more = i < _dps310_count ? _dps310[i].update(left) :
+                                              _ads1x1x[i - _dps310_count].update(left);
+        if (more) { pending = true; }
+    }
+    return pending;
+}
+
+void Discovery::end() {
+    for (int i = 0; i < _dps310_count; ++i) { _dps310[i].end(); }
+    for (int i = 0; i < _ads1x1x_count; ++i) { _ads1x1x[i].end(); }
+    if (in(State::WAIT_SETUP)) { return; }
+    set(State::WAIT_BEGIN);
+}
+
+void Discovery::onSleep() {
+    if (not in(State::RUNNING)) { return; }
+    for (int i = 0; i < _dps310_count; ++i) { _dps310[i].onSleep(); }
+    for (int i = 0; i < _ads1x1x_count; ++i) { _ads1x1x[i].onSleep(); }
+}
+
+void Discovery::onWakeup() {
+    if (not in(State::RUNNING)) { return; }
+    for (int i = 0; i < _dps310_count; ++i) { _dps310[i].onWakeup(); }
+    for (int i = 0; i < _ads1x1x_count; ++i) { _ads1x1x[i].onWakeup(); }
+}
+
+uint8_t Discovery::scan() {
+    static const DPS310::Address dps310_addresses[MAX_DPS310] = {
+        DPS310::Address::SECONDARY, DPS310::Address::PRIMARY
+    };
+    static const ADS1x1x::Address ads1x1x_addresses[MAX_ADS1X1X] = {
+        ADS1x1x::Address::PRIMARY, ADS1x1x::Address::SECONDARY,
+        ADS1x1x::Address::TERTIARY, ADS1x1x::Address::QUATERNARY
+    };
+
+    _dps310_count = 0;
+    _ads1x1x_count = 0;
+    _next = 0;
+    if (not _bus.acquire()) { return 0; }
+    const uint32_t started = micros();
+    for (int i = 0; i < MAX_DPS310; ++i) {
+        if (not isDPS310(DPS310::use(dps310_addresses[i]))) { continue; }
+        _dps310[_dps310_count++].setAddress(dps310_addresses[i]);
+    }
+    for (int i = 0; i < MAX_ADS1X1X; ++i) {
+        if (not isADS1x1x(ADS1x1x::use(ads1x1x_addresses[i]))) { continue; }
+        _ads1x1x[_ads1x1x_count++].setAddress(ads1x1x_addresses[i]);
+    }
+    _scan_time = micros() - started;
+    _bus.release();
+    return _dps310_count + _ads1x1x_count;
+}
+
+// MARK: Specific utils (private)
+
+bool Discovery::isDPS310(const uint8_t address) {
+    // Only read from addresses that acknowledge
+    if (not _bus.probe(address)) { return false; }
+    uint8_t id;
+    if (not _bus.readRegister(address, DPS310_PRODUCT_ID_REGISTER, &id, 1)) {
+        return false;
+    }
+    return id == DPS310_PRODUCT_ID;
+}
+
+bool Discovery::isADS1x1x(const uint8_t address) {
+    if (not _bus.probe(address)) { return false; }
+    uint8_t bytes[2];
+    if (not _bus.readRegister(address, ADS1X1X_CONFIG_REGISTER, bytes, 2)) {
+        return false;
+    }
+    const uint16_t config = (bytes[0] << 8) | bytes[1];
+    // The drivers never change the comparator, so it keeps its reset value
+    return config == ADS1X1X_CONFIG_RESET
+        or (config & ADS1X1X_COMPARATOR_MASK)
+        == (ADS1X1X_CONFIG_RESET & ADS1X1X_COMPARATOR_MASK);
+}
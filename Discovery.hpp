@@ -0,0 +1,239 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   Discovery.hpp
+ * @brief  Discovery of the sensors populated on an I2C bus.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "ADS1x1x.hpp"
+#include "DPS310.hpp"
+#include "I2CBus.hpp"
+
+/**
+ * @class Discovery
+ * @brief Finds the DPS310 and ADS1x1x parts on a bus and runs a driver for each.
+ *
+ * Every known address is probed with an address-only transaction; only the
+ * addresses that acknowledge are read to identify the part:
+ * - DPS310 (0x76, 0x77): `PRODUCT_ID` reads 0x10.
+ * - ADS1x1x (0x48 to 0x4B): the config register reads its reset value 0x8583, or,
+ *   after a warm restart, has the comparator bits still at their reset value.
+ *
+ * The drivers come from fixed pools inside the object, so nothing is allocated.
+ * The scan takes a few milliseconds; starting the DPS310 drivers takes longer
+ * (see `DPS310::begin()`).
+ */
+class Discovery {
+public:
+    // MARK: Constants (public)
+
+    /// Number of DPS310 addresses
+    static const int MAX_DPS310 = 2;
+
+    /// Number of ADS1x1x addresses
+    static const int MAX_ADS1X1X = 4;
+
+private:
+    // MARK: Constants (private)
+
+    /// DPS310 `PRODUCT_ID` register
+    static const uint8_t DPS310_PRODUCT_ID_REGISTER = 0x0D;
+
+    /// Genuine DPS310 product and revision ID
+    static const uint8_t DPS310_PRODUCT_ID = 0x10;
+
+    /// ADS1x1x config register
+    static const uint8_t ADS1X1X_CONFIG_REGISTER = 0x01;
+
+    /// ADS1x1x config register after power-up
+    static const uint16_t ADS1X1X_CONFIG_RESET = 0x8583;
+
+    /// Comparator bits of the ADS1x1x config register
+    static const uint16_t ADS1X1X_COMPARATOR_MASK = 0x001F;
+
+private:
+    // MARK: States (private)
+
+    /**
+     * @brief Enumeration of internal states for the discovery.
+     */
+    enum class State : int {
+        WAIT_SETUP,    ///< Waiting for setup to complete.
+        WAIT_BEGIN,    ///< Waiting for the begin signal.
+        RUNNING        ///< The found drivers are running.
+    };
+
+    /**
+     * @brief Sets the state of the discovery.
+     * @param state The new state.
+     */
+    inline void set(const State state) { _state = state; }
+
+    /**
+     * @brief Checks if the discovery is in a specific state.
+     * @param state The state to check.
+     * @return `true` if the discovery is in the given state; otherwise, `false`.
+     */
+    inline bool in(const State state) { return _state == state; }
+
+private:
+    // MARK: Variables (private)
+
+    /// Current state of the discovery
+    State _state;
+
+    /// The bus to scan
+    I2CBus& _bus;
+
+    /// Settings of the DPS310 drivers
+    DPS310::Settings _dps310_settings;
+
+    /// Device type of the ADS1x1x parts
+    ADS1x1x::DeviceType _ads1x1x_type;
+
+    /// Settings of the ADS1x1x drivers
+    ADS1x1x::Settings _ads1x1x_settings;
+
+    /// Pool of DPS310 drivers; the first `_dps310_count` are in use
+    DPS310 _dps310[MAX_DPS310];
+
+    /// Number of DPS310 parts found
+    uint8_t _dps310_count;
+
+    /// Pool of ADS1x1x drivers; the first `_ads1x1x_count` are in use
+    ADS1x1x _ads1x1x[MAX_ADS1X1X];
+
+    /// Number of ADS1x1x parts found
+    uint8_t _ads1x1x_count;
+
+    /// Driver updated first, counting the DPS310 drivers before the ADS1x1x ones
+    uint8_t _next;
+
+    /// Duration of the latest scan (us)
+    uint32_t _scan_time;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the discovery.
+     * @param bus The bus to scan.
+     */
+    Discovery(I2CBus& bus = I2CBus::getDefault())
+        : _state(State::WAIT_SETUP), _bus(bus),
+          _dps310_settings(DPS310::Settings::Presets::DEFAULT),
+          _ads1x1x_type(ADS1x1x::DeviceType::ADS101x),
+          _ads1x1x_settings(ADS1x1x::Settings::Presets::DEFAULT), _dps310_count(0),
+          _ads1x1x_count(0), _next(0), _scan_time(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Setup the discovery with the settings given to the found drivers.
+     *
+     * The registers cannot tell an ADS101x from an ADS111x, so the type is given.
+     *
+     * @param dps310_settings Settings of the DPS310 drivers.
+     * @param ads1x1x_type Device type of the ADS1x1x parts.
+     * @param ads1x1x_settings Settings of the ADS1x1x drivers.
+     */
+    void setup(const DPS310::Settings& dps310_settings =
+                   DPS310::Settings(DPS310::Settings::Presets::DEFAULT),
+               const ADS1x1x::DeviceType ads1x1x_type = ADS1x1x::DeviceType::ADS101x,
+               const ADS1x1x::Settings& ads1x1x_settings =
+                   ADS1x1x::Settings(ADS1x1x::Settings::Presets::DEFAULT));
+
+    /**
+     * @brief Scan the bus, then setup and begin a driver for each part found.
+     */
+    void begin();
+
+    /**
+     * @brief Update the found drivers.
+     *
+     * Call periodically in the main loop. With a budget, each driver gets what is
+     * left of it; the drivers after the budget runs out wait for the next call.
+     *
+     * @param budget Time the call may take (us); 0 for a single step per driver.
+     * @return `true` if work is left that the next call can do at once; otherwise,
+     *     `false`.
+     */
+    bool update(const uint32_t budget = 0);
+
+    /**
+     * @brief End the found drivers.
+     */
+    void end();
+
+    /**
+     * @brief Put the found devices into their low-power state.
+     */
+    void onSleep();
+
+    /**
+     * @brief Resume the found devices after sleep.
+     */
+    void onWakeup();
+
+    /**
+     * @brief Probe and identify the parts, without starting drivers.
+     * @return The number of parts found.
+     */
+    uint8_t scan();
+
+    /// Number of DPS310 parts found.
+    inline uint8_t getDPS310Count() const { return _dps310_count; }
+
+    /**
+     * @brief Retrieves the driver of a DPS310 part found.
+     * @param index Index from 0 to `getDPS310Count()` - 1, in address order.
+     * @return The driver.
+     */
+    inline DPS310& getDPS310(const int index) { return _dps310[index]; }
+
+    /// Number of ADS1x1x parts found.
+    inline uint8_t getADS1x1xCount() const { return _ads1x1x_count; }
+
+    /**
+     * @brief Retrieves the driver of an ADS1x1x part found.
+     * @param index Index from 0 to `getADS1x1xCount()` - 1, in address order.
+     * @return The driver.
+     */
+    inline ADS1x1x& getADS1x1x(const int index) { return _ads1x1x[index]; }
+
+    /**
+     * @brief Retrieves how long the latest scan took.
+     * @return The duration of the probes and identification reads (us).
+     */
+    inline uint32_t getScanTime() const { return _scan_time; }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Check whether a DPS310 answers at an address.
+     * @param address 7-bit address.
+     * @return `true` if a DPS310 was identified; otherwise, `false`.
+     */
+    bool isDPS310(const uint8_t address);
+
+    /**
+     * @brief Check whether an ADS1x1x answers at an address.
+     * @param address 7-bit address.
+     * @return `true` if an ADS1x1x was identified; otherwise, `false`.
+     */
+    bool isADS1x1x(const uint8_t address);
+};
@@ -0,0 +1,150 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   EnergyMeter.hpp
+ * @brief  Modelled energy spent by a sensor and its bus traffic.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class EnergyMeter
+ * @brief Adds up the energy a driver spends, from a model instead of a measurement.
+ *
+ * The driver charges each conversion with the datasheet current of the part for
+ * the conversion time, and each I2C byte with a fixed bus energy. The bus energy
+ * defaults to SDA and SCL each pulled low half of a 400 kHz byte through 4.7 kΩ at
+ * 3.3 V; change it for other pull-ups or speeds.
+ *
+ * Energy is counted per sample, from `startSample()` to `completeSample()`, and
+ * in total, including samples that failed. Standby currents are not counted.
+ */
+class EnergyMeter {
+public:
+    // MARK: Constants (public)
+
+    /// Default supply voltage (mV)
+    static const uint16_t DEFAULT_SUPPLY = 3300;
+
+    /// Default energy of one I2C byte, including its acknowledge bit (nJ)
+    static const uint16_t DEFAULT_BYTE_ENERGY = 52;
+
+private:
+    // MARK: Variables (private)
+
+    /// Supply voltage of the sensor (mV)
+    uint16_t _supply;
+
+    /// Energy of one I2C byte (nJ)
+    uint16_t _byte_energy;
+
+    /// Total energy (uJ)
+    uint32_t _total;
+
+    /// Part of the total below 1 uJ (nJ)
+    uint32_t _carry;
+
+    /// Energy of the sample in progress (nJ)
+    uint32_t _running;
+
+    /// Energy of the latest completed sample (nJ)
+    uint32_t _last;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the meter.
+     */
+    EnergyMeter()
+        : _supply(DEFAULT_SUPPLY), _byte_energy(DEFAULT_BYTE_ENERGY), _total(0),
+          _carry(0), _running(0), _last(0) {}
+
+public:
+    // MARK: Set/Get (public)
+
+    /// Supply voltage of the sensor (mV).
+    inline uint16_t getSupply() const { return _supply; }
+
+    /// Sets the supply voltage of the sensor (mV).
+    inline void setSupply(const uint16_t supply) { _supply = supply; }
+
+    /// Energy of one I2C byte (nJ).
+    inline uint16_t getByteEnergy() const { return _byte_energy; }
+
+    /// Sets the energy of one I2C byte (nJ).
+    inline void setByteEnergy(const uint16_t energy) { _byte_energy = energy; }
+
+    /// Total energy (uJ).
+    inline uint32_t getTotal() const { return _total; }
+
+    /// Energy of the latest completed sample (nJ).
+    inline uint32_t getLast() const { return _last; }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Charge a conversion.
+     *
+     * @param current Current drawn while converting (uA).
+     * @param duration Conversion time (us).
+     */
+    inline void addConversion(const uint32_t current, const uint32_t duration) {
+        // uA * mV = nW; divided early to stay in 32 bits up to seconds
+        add(current * _supply / 1000 * duration / 1000);
+    }
+
+    /**
+     * @brief Charge I2C traffic.
+     * @param count Number of bytes, including the address bytes.
+     */
+    inline void addBytes(const uint32_t count) { add(count * _byte_energy); }
+
+    /**
+     * @brief Start counting a new sample; the energy of an unfinished one is dropped.
+     */
+    inline void startSample() { _running = 0; }
+
+    /**
+     * @brief Close the sample in progress; it becomes the latest sample.
+     */
+    inline void completeSample() {
+        _last = _running;
+        _running = 0;
+    }
+
+    /**
+     * @brief Clears the energy counted so far.
+     */
+    inline void clear() {
+        _total = 0;
+        _carry = 0;
+        _running = 0;
+        _last = 0;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Add energy to the sample in progress and to the total.
+     * @param energy Energy (nJ).
+     */
+    inline void add(const uint32_t energy) {
+        _running += energy;
+        _carry += energy;
+        _total += _carry / 1000;
+        _carry %= 1000;
+    }
+};
@@ -0,0 +1,542 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   FlashLog.hpp
+ * @brief  Append-only ring log of compressed sensor records on flash or EEPROM.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "Varint.hpp"
+
+/**
+ * @class EepromStorage
+ * @brief Page storage backed by the on-chip EEPROM of the TWELITE.
+ *
+ * Pages are aligned to the 64-byte EEPROM segments, so a block never straddles two
+ * segments. EEPROM needs no erase cycle; erasing a page fills it with `0xFF` so that
+ * empty slots look the same as on flash.
+ *
+ * Any class with the same five methods can be used as a `FlashLog` storage.
+ */
+class EepromStorage {
+public:
+    // MARK: Constants (public)
+
+    /// Size of one EEPROM segment (bytes)
+    static const uint16_t SEGMENT_SIZE = 64;
+
+private:
+    // MARK: Variables (private)
+
+    /// First byte address used by the log
+    uint16_t _base;
+
+    /// Number of pages used by the log
+    uint16_t _page_count;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the storage.
+     *
+     * @param base First byte address used by the log (multiple of 64).
+     * @param page_count Number of 64-byte pages used by the log.
+     */
+    EepromStorage(const uint16_t base = 0, const uint16_t page_count = 60)
+        : _base(base), _page_count(page_count) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    inline uint16_t getPageSize() const { return SEGMENT_SIZE; }
+    inline uint16_t getPageCount() const { return _page_count; }
+
+    bool read(const uint16_t page, const uint16_t offset, uint8_t* const dst,
+              const uint16_t length) {
+        const uint16_t address = _base + page * SEGMENT_SIZE + offset;
+        for (uint16_t i = 0; i < length; ++i) { dst[i] = EEPROM.read(address + i); }
+        return true;
+    }
+
+    bool write(const uint16_t page, const uint16_t offset, const uint8_t* const src,
+               const uint16_t length) {
+        const uint16_t address = _base + page * SEGMENT_SIZE + offset;
+        for (uint16_t i = 0; i < length; ++i) { EEPROM.write(address + i, src[i]); }
+        return true;
+    }
+
+    bool erase(const uint16_t page) {
+        const uint16_t address = _base + page * SEGMENT_SIZE;
+        for (uint16_t i = 0; i < SEGMENT_SIZE; ++i) { EEPROM.write(address + i, 0xFF); }
+        return true;
+    }
+};
+
+/**
+ * @class FlashLog
+ * @brief Persistent ring log of sensor records with fast head recovery.
+ *
+ * Records are delta-encoded into a RAM block and written once per block, so each
+ * byte reaches the storage exactly once apart from the page header. Pages are used
+ * in a ring, which spreads erase cycles evenly over the whole area (wear levelling);
+ * when the ring is full the oldest page is overwritten.
+ *
+ * Layout:
+ * - Page: 8-byte header (magic, 32-bit sequence number, check word), then block slots.
+ * - Block slot: `BLOCK_SIZE` bytes; [payload length][record count][flags][CRC-8],
+ *   then the payload. A slot whose length byte reads `0xFF` is empty.
+ * - Payload: the first record holds the absolute time and values, later records the
+ *   varint deltas from the previous record. Each block decodes on its own.
+ *
+ * Recovery after reset does not scan the storage: the page with the newest
+ * sequence number is found by binary search over the page headers, then the
+ * first empty slot in that page by binary search over the slot length bytes.
+ * Blocks already sent to the gateway are marked by clearing a bit in their flags
+ * byte, which flash allows without erasing, and the first unsent block is found by
+ * binary search as well. Recovery costs O(log pages + log blocks) reads.
+ *
+ * @tparam Storage Page storage (see `EepromStorage`).
+ * @tparam CHANNELS Number of values per record.
+ * @tparam BLOCK_SIZE Size of a block slot (bytes); must divide into the page and
+ *     hold 4 header bytes plus 5 bytes per channel and for the time.
+ */
+template <typename Storage, int CHANNELS, int BLOCK_SIZE = 28>
+class FlashLog {
+    static_assert(CHANNELS >= 1, "At least one channel is required");
+    static_assert(BLOCK_SIZE > 8 and BLOCK_SIZE <= 255, "Block size must be within 9 to 255");
+
+public:
+    // MARK: Settings (public)
+
+    /**
+     * @brief One decoded sensor record.
+     */
+    struct Record {
+        uint32_t time;               ///< Time of the record (any unit, e.g. s or ms)
+        int32_t values[CHANNELS];    ///< Values in channel order
+    };
+
+private:
+    // MARK: Constants (private)
+
+    /// Page header size (bytes)
+    static const uint16_t PAGE_HEADER_SIZE = 8;
+
+    /// Page header magic number
+    static const uint16_t PAGE_MAGIC = 0x4C53;
+
+    /// Block header size (bytes)
+    static const uint16_t BLOCK_HEADER_SIZE = 4;
+
+    /// Payload capacity of a block (bytes)
+    static const uint16_t BLOCK_PAYLOAD_SIZE = BLOCK_SIZE - BLOCK_HEADER_SIZE;
+
+    /// Flags bit cleared once the block has been acknowledged
+    static const uint8_t FLAG_UNSENT = 0x80;
+
+    /// Largest encoded record (bytes)
+    static const int RECORD_MAX_SIZE = (1 + CHANNELS) * Varint::MAX_LENGTH;
+    static_assert(RECORD_MAX_SIZE <= BLOCK_PAYLOAD_SIZE,
+                  "Block size must hold the largest record; raise BLOCK_SIZE");
+
+    /// Value of an erased byte
+    static const uint8_t ERASED = 0xFF;
+
+private:
+    // MARK: Variables (private)
+
+    /// Page storage
+    Storage& _storage;
+
+    /// Number of pages
+    uint16_t _page_count;
+
+    /// Number of block slots per page
+    uint16_t _blocks_per_page;
+
+    /// Page currently written
+    uint16_t _head_page;
+
+    /// Next free slot in the head page
+    uint16_t _head_slot;
+
+    /// Sequence number of the head page
+    uint32_t _head_seq;
+
+    /// Page holding the oldest blocks
+    uint16_t _oldest_page;
+
+    /// Logical index (from the oldest block) of the first unacknowledged block
+    uint32_t _unsent;
+
+    /// Block being assembled
+    uint8_t _block[BLOCK_SIZE];
+
+    /// Payload bytes in the block being assembled
+    uint16_t _fill;
+
+    /// Records in the block being assembled
+    uint8_t _count;
+
+    /// Previous record in the block being assembled
+    Record _previous;
+
+    /// Bytes written to the storage since `begin()`
+    uint32_t _bytes_written;
+
+    /// Pages erased since `begin()`
+    uint32_t _pages_erased;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the log.
+     * @param storage Page storage to use.
+     */
+    FlashLog(Storage& storage)
+        : _storage(storage), _page_count(0), _blocks_per_page(0), _head_page(0),
+          _head_slot(0), _head_seq(0), _oldest_page(0), _unsent(0), _block { 0 },
+          _fill(0), _count(0), _previous(), _bytes_written(0), _pages_erased(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Recover the write head and the unsent position from the storage.
+     *
+     * Formats the first page if the storage holds no log.
+     *
+     * @return `true` on success; `false` if the storage failed or is too small.
+     */
+    bool begin() {
+        _page_count = _storage.getPageCount();
+        _blocks_per_page = (_storage.getPageSize() - PAGE_HEADER_SIZE) / BLOCK_SIZE;
+        _fill = 0;
+        _count = 0;
+        _bytes_written = 0;
+        _pages_erased = 0;
+        if (_page_count < 2 or _blocks_per_page < 1) { return false; }
+
+        // Head page: last page of the ascending run that starts at page 0
+        uint32_t seq0, seq;
+        if (readPageHeader(0, &seq0)) {
+            uint16_t lo = 0, hi = _page_count - 1;
+            while (lo < hi) {
+                const uint16_t mid = (lo + hi + 1) / 2;
+                if (readPageHeader(mid, &seq) and seq >= seq0) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            _head_page = lo;
+            readPageHeader(_head_page, &_head_seq);
+        } else if (readPageHeader(_page_count - 1, &seq)) {
+            // Page 0 was being recycled when power was lost
+            _head_page = _page_count - 1;
+            _head_seq = seq;
+        } else {
+            _head_page = 0;
+            _head_slot = 0;
+            _head_seq = 0;
+            _oldest_page = 0;
+            _unsent = 0;
+            return startPage(0, 1);
+        }
+
+        // Head slot: first empty slot in the head page
+        uint16_t lo = 0, hi = _blocks_per_page;
+        while (lo < hi) {
+            const uint16_t mid = (lo + hi) / 2;
+            uint8_t length;
+            if (not _storage.read(_head_page, slotOffset(mid), &length, 1)) { return false; }
+            if (length != ERASED) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        _head_slot = lo;
+
+        // Oldest page: the next page in the ring that holds an older sequence number
+        _oldest_page = 0;
+        for (uint16_t step = 1; step <= 2; ++step) {
+            const uint16_t page = (_head_page + step) % _page_count;
+            if (page != _head_page and readPageHeader(page, &seq) and seq < _head_seq) {
+                _oldest_page = page;
+                break;
+            }
+        }
+
+        // Unsent position: first block whose flags still have the unsent bit
+        uint32_t first = 0, last = getStoredBlocks();
+        while (first < last) {
+            const uint32_t mid = (first + last) / 2;
+            uint8_t flags;
+            if (not readFlags(mid, &flags)) { return false; }
+            if (flags & FLAG_UNSENT) {
+                last = mid;
+            } else {
+                first = mid + 1;
+            }
+        }
+        _unsent = first;
+        return true;
+    }
+
+    /**
+     * @brief Append a record.
+     *
+     * The record is buffered in RAM and reaches the storage when its block is full
+     * or on `flush()`.
+     *
+     * @param time Time of the record.
+     * @param values `CHANNELS` values in channel order.
+     * @return `true` on success; `false` if a storage write failed.
+     */
+    bool append(const uint32_t time, const int32_t* const values) {
+        uint8_t encoded[RECORD_MAX_SIZE];
+        int length = encode(time, values, encoded);
+        if (_fill + length > BLOCK_PAYLOAD_SIZE) {
+            if (not flush()) { return false; }
+            length = encode(time, values, encoded);
+        }
+        memcpy(&_block[BLOCK_HEADER_SIZE + _fill], encoded, length);
+        _fill += length;
+        ++_count;
+        _previous.time = time;
+        for (int ch = 0; ch < CHANNELS; ++ch) { _previous.values[ch] = values[ch]; }
+        return true;
+    }
+
+    /**
+     * @brief Write the block being assembled to the storage.
+     *
+     * Only the used part of the slot is written. Recycles the oldest page when the
+     * head page is full.
+     *
+     * @return `true` on success; `false` if a storage write failed.
+     */
+    bool flush() {
+        if (_count == 0) { return true; }
+        if (_head_slot >= _blocks_per_page) {
+            const uint16_t next = (_head_page + 1) % _page_count;
+            if (not startPage(next, _head_seq + 1)) { return false; }
+        }
+        _block[0] = static_cast<uint8_t>(_fill);
+        _block[1] = _count;
+        _block[2] = ERASED;
+        _block[3] = crc8(&_block[BLOCK_HEADER_SIZE], _fill);
+        const uint16_t length = BLOCK_HEADER_SIZE + _fill;
+        if (not _storage.write(_head_page, slotOffset(_head_slot), _block, length)) {
+            return false;
+        }
+        _bytes_written += length;
+        ++_head_slot;
+        _fill = 0;
+        _count = 0;
+        return true;
+    }
+
+    /**
+     * @brief Decode the oldest block that has not been acknowledged.
+     *
+     * Blocks that fail their CRC are acknowledged and skipped.
+     *
+     * @param records Destination for the decoded records.
+     * @param max Capacity of `records`.
+     * @return The number of records decoded, or `0` if every stored block was sent.
+     */
+    int peek(Record* const records, const int max) {
+        while (_unsent < getStoredBlocks()) {
+            uint8_t block[BLOCK_SIZE];
+            uint16_t page, slot;
+            locate(_unsent, &page, &slot);
+            if (not _storage.read(page, slotOffset(slot), block, BLOCK_SIZE)) { return 0; }
+            const uint8_t length = block[0];
+            if (length <= BLOCK_PAYLOAD_SIZE
+                and crc8(&block[BLOCK_HEADER_SIZE], length) == block[3]) {
+                return decode(&block[BLOCK_HEADER_SIZE], length, block[1], records, max);
+            }
+            if (not acknowledge()) { return 0; }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Mark the block returned by `peek()` as sent.
+     * @return `true` on success; `false` if nothing is pending or the write failed.
+     */
+    bool acknowledge() {
+        if (_unsent >= getStoredBlocks()) { return false; }
+        uint16_t page, slot;
+        locate(_unsent, &page, &slot);
+        const uint8_t flags = ERASED & ~FLAG_UNSENT;
+        if (not _storage.write(page, slotOffset(slot) + 2, &flags, 1)) { return false; }
+        _bytes_written += 1;
+        ++_unsent;
+        return true;
+    }
+
+    /**
+     * @brief Retrieves the number of blocks in the storage.
+     * @return Stored block count, sent or not.
+     */
+    uint32_t getStoredBlocks() const {
+        const uint16_t full_pages = (_head_page + _page_count - _oldest_page) % _page_count;
+        return static_cast<uint32_t>(full_pages) * _blocks_per_page + _head_slot;
+    }
+
+    /**
+     * @brief Retrieves the number of blocks not yet acknowledged.
+     * @return Pending block count (excluding the block being assembled).
+     */
+    inline uint32_t getPendingBlocks() const { return getStoredBlocks() - _unsent; }
+
+    /**
+     * @brief Retrieves the number of bytes written since `begin()`.
+     * @return Bytes written, including page headers and flag updates.
+     */
+    inline uint32_t getBytesWritten() const { return _bytes_written; }
+
+    /**
+     * @brief Retrieves the number of page erases since `begin()`.
+     * @return Erase count.
+     */
+    inline uint32_t getPagesErased() const { return _pages_erased; }
+
+private:
+    // MARK: Specific utils (private)
+
+    /// Byte offset of a block slot within a page.
+    inline uint16_t slotOffset(const uint16_t slot) const {
+        return PAGE_HEADER_SIZE + slot * BLOCK_SIZE;
+    }
+
+    /// Page and slot of a logical block index counted from the oldest block.
+    inline void locate(const uint32_t index, uint16_t* const page, uint16_t* const slot) const {
+        *page = (_oldest_page + index / _blocks_per_page) % _page_count;
+        *slot = index % _blocks_per_page;
+    }
+
+    /// Read the flags byte of a logical block.
+    inline bool readFlags(const uint32_t index, uint8_t* const flags) {
+        uint16_t page, slot;
+        locate(index, &page, &slot);
+        return _storage.read(page, slotOffset(slot) + 2, flags, 1);
+    }
+
+    /**
+     * @brief Read and validate a page header.
+     * @param page Page to read.
+     * @param seq Pointer to store the sequence number.
+     * @return `true` if the page holds a valid header; otherwise, `false`.
+     */
+    bool readPageHeader(const uint16_t page, uint32_t* const seq) {
+        uint8_t h[PAGE_HEADER_SIZE];
+        if (not _storage.read(page, 0, h, PAGE_HEADER_SIZE)) { return false; }
+        if ((h[0] | (h[1] << 8)) != PAGE_MAGIC) { return false; }
+        *seq = h[2] | (h[3] << 8) | (static_cast<uint32_t>(h[4]) << 16)
+            | (static_cast<uint32_t>(h[5]) << 24);
+        return (h[6] | (h[7] << 8)) == checkWord(*seq);
+    }
+
+    /**
+     * @brief Erase a page and write its header, making it the head page.
+     * @param page Page to start.
+     * @param seq Sequence number of the page.
+     * @return `true` on success; otherwise, `false`.
+     */
+    bool startPage(const uint16_t page, const uint32_t seq) {
+        const bool recycled = _head_slot > 0 or _head_page != page;
+        if (page == _oldest_page and recycled) {
+            // The oldest page is about to be overwritten
+            _oldest_page = (_oldest_page + 1) % _page_count;
+            _unsent = _unsent > _blocks_per_page ? _unsent - _blocks_per_page : 0;
+        }
+        if (not _storage.erase(page)) { return false; }
+        ++_pages_erased;
+        const uint16_t check = checkWord(seq);
+        const uint8_t h[PAGE_HEADER_SIZE] = {
+            static_cast<uint8_t>(PAGE_MAGIC & 0xFF), static_cast<uint8_t>(PAGE_MAGIC >> 8),
+            static_cast<uint8_t>(seq), static_cast<uint8_t>(seq >> 8),
+            static_cast<uint8_t>(seq >> 16), static_cast<uint8_t>(seq >> 24),
+            static_cast<uint8_t>(check), static_cast<uint8_t>(check >> 8)
+        };
+        if (not _storage.write(page, 0, h, PAGE_HEADER_SIZE)) { return false; }
+        _bytes_written += PAGE_HEADER_SIZE;
+        _head_page = page;
+        _head_slot = 0;
+        _head_seq = seq;
+        return true;
+    }
+
+    /**
+     * @brief Encode a record against the previous one in the block.
+     * @return The number of bytes written to `dst`.
+     */
+    int encode(const uint32_t time, const int32_t* const values, uint8_t* const dst) const {
+        const bool first = _count == 0;
+        int length = Varint::encode(first ? time : time - _previous.time, dst);
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            const int32_t delta = first ? values[ch] : values[ch] - _previous.values[ch];
+            length += Varint::encode(Varint::zigzag(delta), &dst[length]);
+        }
+        return length;
+    }
+
+    /**
+     * @brief Decode the records of a block payload.
+     * @return The number of records decoded.
+     */
+    static int decode(const uint8_t* const src, const int size, const int count,
+                      Record* const records, const int max) {
+        Record current = Record();
+        int pos = 0, n = 0;
+        for (; n < count and n < max; ++n) {
+            uint32_t value;
+            int used = Varint::decode(&src[pos], size - pos, &value);
+            if (used == 0) { break; }
+            pos += used;
+            current.time = n == 0 ? value : current.time + value;
+            for (int ch = 0; ch < CHANNELS; ++ch) {
+                used = Varint::decode(&src[pos], size - pos, &value);
+                if (used == 0) { return n; }
+                pos += used;
+                current.values[ch] = (n == 0 ? 0 : current.values[ch]) + Varint::unzigzag(value);
+            }
+            records[n] = current;
+        }
+        return n;
+    }
+
+    /// Check word stored next to a page sequence number.
+    static inline uint16_t checkWord(const uint32_t seq) {
+        return static_cast<uint16_t>(~(seq ^ (seq >> 16)));
+    }
+
+    /// CRC-8 (polynomial 0x07) over a byte range.
+    static uint8_t crc8(const uint8_t* const data, const int length) {
+        uint8_t crc = 0;
+        for (int i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (int b = 0; b < 8; ++b) {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : crc << 1;
+            }
+        }
+        return crc;
+    }
+};
@@ -0,0 +1,129 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   FlashLogFileStorage.hpp
+ * @brief  File-backed page storage for running `FlashLog` on a host PC.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Host builds only: uses the C standard I/O library instead of the MWX library.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @class FileStorage
+ * @brief Page storage kept in a regular file, with flash-like erase semantics.
+ *
+ * Stands in for the EEPROM or flash of the device when measuring `FlashLog` write
+ * throughput and recovery time on a host. Counts reads, writes and erases so the
+ * write amplification and the reads spent on recovery can be reported.
+ */
+class FileStorage {
+private:
+    // MARK: Variables (private)
+
+    /// Backing file
+    FILE* _file;
+
+    /// Page size (bytes)
+    uint16_t _page_size;
+
+    /// Number of pages
+    uint16_t _page_count;
+
+public:
+    /// Read calls since construction
+    uint32_t read_count;
+
+    /// Bytes written since construction
+    uint32_t bytes_written;
+
+    /// Page erases since construction
+    uint32_t erase_count;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the storage.
+     *
+     * Opens an existing file, or creates one filled with `0xFF`.
+     *
+     * @param path Path of the backing file.
+     * @param page_size Page size (bytes).
+     * @param page_count Number of pages.
+     */
+    FileStorage(const char* const path, const uint16_t page_size, const uint16_t page_count)
+        : _file(fopen(path, "r+b")), _page_size(page_size), _page_count(page_count),
+          read_count(0), bytes_written(0), erase_count(0) {
+        if (_file) { return; }
+        _file = fopen(path, "w+b");
+        if (not _file) { return; }
+        for (uint16_t page = 0; page < _page_count; ++page) { erase(page); }
+        erase_count = 0;
+    }
+
+    /**
+     * @brief Destructor for the storage.
+     */
+    ~FileStorage() {
+        if (_file) { fclose(_file); }
+    }
+
+public:
+    // MARK: Interfaces (public)
+
+    inline uint16_t getPageSize() const { return _page_size; }
+    inline uint16_t getPageCount() const { return _page_count; }
+
+    bool read(const uint16_t page, const uint16_t offset, uint8_t* const dst,
+              const uint16_t length) {
+        ++read_count;
+        return seek(page, offset) and fread(dst, 1, length, _file) == length;
+    }
+
+    bool write(const uint16_t page, const uint16_t offset, const uint8_t* const src,
+               const uint16_t length) {
+        // Flash can only clear bits without an erase
+        uint8_t current[256];
+        if (length > sizeof(current) or not read(page, offset, current, length)) {
+            return false;
+        }
+        --read_count;
+        for (uint16_t i = 0; i < length; ++i) { current[i] &= src[i]; }
+        bytes_written += length;
+        return seek(page, offset) and fwrite(current, 1, length, _file) == length
+            and fflush(_file) == 0;
+    }
+
+    bool erase(const uint16_t page) {
+        uint8_t erased[256];
+        memset(erased, 0xFF, sizeof(erased));
+        if (not seek(page, 0)) { return false; }
+        for (uint16_t done = 0; done < _page_size;) {
+            const uint16_t rest = _page_size - done;
+            const uint16_t chunk = rest < sizeof(erased) ? rest : sizeof(erased);
+            if (fwrite(erased, 1, chunk, _file) != chunk) { return false; }
+            done += chunk;
+        }
+        ++erase_count;
+        return fflush(_file) == 0;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    inline bool seek(const uint16_t page, const uint16_t offset) {
+        return _file and page < _page_count
+            and fseek(_file, static_cast<long>(page) * _page_size + offset, SEEK_SET) == 0;
+    }
+};
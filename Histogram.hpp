@@ -0,0 +1,260 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   Histogram.hpp
+ * @brief  Fixed-size log-bucketed histogram with percentile extraction.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @def HISTOGRAM_DIAGNOSTICS
+ * @brief Set to 1 for the whole build (e.g. `-DHISTOGRAM_DIAGNOSTICS=1`) to keep the
+ * timing histograms of the drivers and of `ADS1x1xScheduler`.
+ *
+ * Off by default: the histograms take over 600 bytes per driver, and
+ * `DiagnosticHistogram` is then a `NullHistogram` that keeps only the count and
+ * the maximum.
+ */
+#ifndef HISTOGRAM_DIAGNOSTICS
+#define HISTOGRAM_DIAGNOSTICS 0
+#endif
+
+/**
+ * @class Histogram
+ * @brief Distribution of unsigned values in logarithmic buckets.
+ *
+ * Values below 8 have a bucket each. Above that, every power of two is split into
+ * `SUB_BUCKETS` buckets, so a bucket is at most 1/4 of its lower bound wide and a
+ * percentile is within 25% of the true value. Values beyond the last bucket are
+ * counted in it; the exact maximum is kept apart.
+ *
+ * Adding a value costs one bit scan and one increment. The counts are 16-bit; when
+ * one would overflow, all counts are halved, so after a long run older values weigh
+ * less than recent ones.
+ *
+ * The last bucket starts at `lowerBoundOf(BUCKETS - 1)`:
+ * - 24 buckets: 112.
+ * - 48 buckets: 7168.
+ * - 72 buckets: 458752.
+ * - 80 buckets: 1835008.
+ *
+ * @tparam BUCKETS Number of buckets, at least 8.
+ */
+template <int BUCKETS>
+class Histogram {
+public:
+    // MARK: Constants (public)
+
+    /// Buckets per power of two above 8
+    static const int SUB_BUCKETS = 4;
+
+private:
+    // MARK: Variables (private)
+
+    /// Counts of the buckets
+    uint16_t _buckets[BUCKETS];
+
+    /// Sum of the counts
+    uint32_t _count;
+
+    /// Largest value added since the last clear
+    uint32_t _max;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the histogram.
+     */
+    Histogram() : _buckets {}, _count(0), _max(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Add a value.
+     * @param value The value.
+     */
+    void add(const uint32_t value) {
+        const int index = indexOf(value);
+        if (_buckets[index] == 0xFFFF) { halve(); }
+        ++_buckets[index];
+        ++_count;
+        if (value > _max) { _max = value; }
+    }
+
+    /**
+     * @brief Retrieves a percentile.
+     *
+     * @param fraction Fraction of the values at or below the result, from 0 to 1.
+     * @return The upper bound of the bucket holding the percentile, at most the
+     *     maximum; 0 if the histogram is empty.
+     */
+    uint32_t getPercentile(const float fraction) const {
+        if (_count == 0) { return 0; }
+        // The rank of the value, counted from 1; rounded, as 0.99f is not exact
+        uint32_t rank = static_cast<uint32_t>(fraction * _count + 0.5f);
+        if (rank < 1) { rank = 1; }
+        uint32_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += _buckets[i];
+            if (seen < rank) { continue; }
+            if (i == BUCKETS - 1) { return _max; }
+            const uint32_t upper = lowerBoundOf(i + 1) - 1;
+            return upper < _max ? upper : _max;
+        }
+        return _max;
+    }
+
+    /// Median.
+    inline uint32_t getP50() const { return getPercentile(0.50f); }
+
+    /// 95th percentile.
+    inline uint32_t getP95() const { return getPercentile(0.95f); }
+
+    /// 99th percentile.
+    inline uint32_t getP99() const { return getPercentile(0.99f); }
+
+    /// Largest value added since the last clear.
+    inline uint32_t getMax() const { return _max; }
+
+    /// Sum of the counts; fewer than the values added once counts were halved.
+    inline uint32_t getCount() const { return _count; }
+
+    /// Count of a bucket.
+    inline uint16_t getBucket(const int index) const { return _buckets[index]; }
+
+    /**
+     * @brief Discard all values.
+     */
+    void clear() {
+        for (int i = 0; i < BUCKETS; ++i) { _buckets[i] = 0; }
+        _count = 0;
+        _max = 0;
+    }
+
+    /**
+     * @brief Retrieves the smallest value counted in a bucket.
+     * @param index Index of the bucket.
+     * @return The lower bound.
+     */
+    static inline uint32_t lowerBoundOf(const int index) {
+        if (index < 2 * SUB_BUCKETS) { return index; }
+        const int shift = index / SUB_BUCKETS - 1;
+        return static_cast<uint32_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Find the bucket of a value.
+     * @param value The value.
+     * @return The index of the bucket, at most `BUCKETS - 1`.
+     */
+    static inline int indexOf(const uint32_t value) {
+        if (value < 2 * SUB_BUCKETS) { return value; }
+        // Two bits below the leading one select the sub-bucket
+        const int shift = (31 - __builtin_clz(value)) - 2;
+        const int index = (shift + 1) * SUB_BUCKETS + ((value >> shift) & 0x3);
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+
+    /**
+     * @brief Halve all counts.
+     */
+    void halve() {
+        _count = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            _buckets[i] /= 2;
+            _count += _buckets[i];
+        }
+    }
+};
+
+/**
+ * @class NullHistogram
+ * @brief Stand-in for `Histogram` without buckets.
+ *
+ * Keeps the count and the exact maximum; every percentile reads as the maximum,
+ * and every bucket as empty.
+ *
+ * @tparam BUCKETS Number of buckets of the `Histogram` it stands in for.
+ */
+template <int BUCKETS>
+class NullHistogram {
+private:
+    // MARK: Variables (private)
+
+    /// Number of values added
+    uint32_t _count;
+
+    /// Largest value added since the last clear
+    uint32_t _max;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the stand-in.
+     */
+    NullHistogram() : _count(0), _max(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /// Add a value.
+    inline void add(const uint32_t value) {
+        ++_count;
+        if (value > _max) { _max = value; }
+    }
+
+    /// The maximum, the only bound known.
+    inline uint32_t getPercentile(const float) const { return _max; }
+    inline uint32_t getP50() const { return _max; }
+    inline uint32_t getP95() const { return _max; }
+    inline uint32_t getP99() const { return _max; }
+    inline uint32_t getMax() const { return _max; }
+
+    /// Number of values added.
+    inline uint32_t getCount() const { return _count; }
+
+    /// No bucket holds a count.
+    inline uint16_t getBucket(const int) const { return 0; }
+
+    /// Discard all values.
+    inline void clear() {
+        _count = 0;
+        _max = 0;
+    }
+
+    /// Lower bound of a bucket of the `Histogram`.
+    static inline uint32_t lowerBoundOf(const int index) {
+        return Histogram<BUCKETS>::lowerBoundOf(index);
+    }
+};
+
+/**
+ * @brief Histogram of the driver and scheduler timings; a `Histogram` if
+ * `HISTOGRAM_DIAGNOSTICS` is set, otherwise a `NullHistogram`.
+ *
+ * @tparam BUCKETS Number of buckets.
+ */
+#if HISTOGRAM_DIAGNOSTICS
+template <int BUCKETS>
+using DiagnosticHistogram = Histogram<BUCKETS>;
+#else
+template <int BUCKETS>
+using DiagnosticHistogram = NullHistogram<BUCKETS>;
+#endif
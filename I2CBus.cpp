@@ -0,0 +1,325 @@
+// -*- coding:utf-8-unix -*-
+
+#include "I2CBus.hpp"
+
+// MARK: I2CBus (public)
+
+bool I2CBus::acquire() {
+    if (_users == 0 and not onBegin()) { return false; }
+    ++_users;
+    return true;
+}
+
+void I2CBus::release() {
+    if (_users == 0) { return; }
+    if (--_users == 0) { onEnd(); }
+}
+
+void I2CBus::setMaxSpeed(const Speed speed) {
+    _max_speed = use(speed) < use(getCapability()) ? speed : getCapability();
+}
+
+uint32_t I2CBus::getThroughput(const Speed speed) const {
+    const Stats& stats = _stats[use(speed)];
+    if (stats.time == 0) { return 0; }
+    return static_cast<uint32_t>(uint64_t(stats.bytes) * 1000000 / stats.time);
+}
+
+void I2CBus::clearStats() {
+    for (int i = 0; i < SPEEDS; ++i) { _stats[i] = Stats(); }
+    _errors = Errors();
+}
+
+uint32_t I2CBus::getErrorRate() const {
+    uint32_t attempts = 0;
+    for (int i = 0; i < SPEEDS; ++i) { attempts += _stats[i].transactions; }
+    if (attempts == 0) { return 0; }
+    return static_cast<uint32_t>(uint64_t(_errors.nacks) * 1000000 / attempts);
+}
+
+bool I2CBus::write(const uint8_t address, const uint8_t* const src, const uint8_t length,
+                   const Speed speed) {
+    for (uint8_t attempt = 0;; ++attempt) {
+        if (writeOnce(address, src, length, speed)) { return true; }
+        if (not backoff(attempt)) { return false; }
+    }
+}
+
+bool I2CBus::read(const uint8_t address, uint8_t* const dst, const uint8_t length,
+                  const Speed speed) {
+    for (uint8_t attempt = 0;; ++attempt) {
+        if (readOnce(address, dst, length, speed)) { return true; }
+        if (not backoff(attempt)) { return false; }
+    }
+}
+
+bool I2CBus::readRegister(const uint8_t address, const uint8_t reg, uint8_t* const dst,
+                          const uint8_t length, const Speed speed) {
+    // Retry both halves; a device that missed the read may have lost the address
+    for (uint8_t attempt = 0;; ++attempt) {
+        if (writeOnce(address, &reg, 1, speed)
+            and readOnce(address, dst, length, speed)) {
+            return true;
+        }
+        if (not backoff(attempt)) { return false; }
+    }
+}
+
+bool I2CBus::probe(const uint8_t address) {
+    // Address-only transactions run at the slowest speed every device understands
+    return writeOnce(address, nullptr, 0, Speed::STANDARD);
+}
+
+I2CBus& I2CBus::getDefault() {
+    static WireBus bus;
+    return bus;
+}
+
+// MARK: I2CBus (protected)
+
+bool I2CBus::clearLines(const uint8_t sda, const uint8_t scl) {
+    pinMode(sda, PIN_MODE::INPUT_PULLUP);
+    pinMode(scl, PIN_MODE::INPUT_PULLUP);
+    delayMicroseconds(5);
+    // A device left in the middle of a read holds SDA low; clock it out
+    for (int i = 0; i < 9 and digitalRead(sda) == PIN_STATE::LOW; ++i) {
+        digitalWrite(scl, PIN_STATE::LOW);
+        pinMode(scl, PIN_MODE::OUTPUT);
+        delayMicroseconds(5);
+        pinMode(scl, PIN_MODE::INPUT_PULLUP);
+        delayMicroseconds(5);
+    }
+    // SDA falls and rises while SCL is high: START then STOP
+    digitalWrite(sda, PIN_STATE::LOW);
+    pinMode(sda, PIN_MODE::OUTPUT);
+    delayMicroseconds(5);
+    pinMode(sda, PIN_MODE::INPUT_PULLUP);
+    delayMicroseconds(5);
+    return digitalRead(sda) == PIN_STATE::HIGH;
+}
+
+// MARK: I2CBus (private)
+
+void I2CBus::select(const Speed speed) {
+    const Speed common = use(speed) < use(_max_speed) ? speed : _max_speed;
+    if (common == _speed) { return; }
+    _speed = common;
+    onSpeedChange();
+}
+
+bool I2CBus::writeOnce(const uint8_t address, const uint8_t* const src,
+                       const uint8_t length, const Speed speed) {
+    select(speed);
+    const uint32_t started = micros();
+    const bool acked = transmit(address, src, length);
+    count(length, started);
+    return acked;
+}
+
+bool I2CBus::readOnce(const uint8_t address, uint8_t* const dst, const uint8_t length,
+                      const Speed speed) {
+    select(speed);
+    const uint32_t started = micros();
+    const bool acked = receive(address, dst, length);
+    count(length, started);
+    return acked;
+}
+
+bool I2CBus::backoff(const uint8_t attempt) {
+    ++_errors.nacks;
+    if (attempt >= _retries) {
+        ++_errors.failures;
+        return false;
+    }
+    ++_errors.retries;
+    const uint32_t wait = uint32_t(_backoff) << (attempt < 16 ? attempt : 16);
+    delayMicroseconds(wait < MAX_BACKOFF ? wait : MAX_BACKOFF);
+    return true;
+}
+
+void I2CBus::count(const uint8_t length, const uint32_t started) {
+    Stats& stats = _stats[use(_speed)];
+    ++stats.transactions;
+    stats.bytes += 1 + length;    // Address byte and data bytes
+    stats.time += micros() - started;
+}
+
+// MARK: WireBus (protected)
+
+WireBus* WireBus::_routed = nullptr;
+
+bool WireBus::onBegin() {
+    route();
+    return true;
+}
+
+void WireBus::onSpeedChange() {
+    // Restart the controller with the new clock on the next access
+    if (_routed == this) {
+        Wire.end();
+        _routed = nullptr;
+    }
+}
+
+void WireBus::onEnd() {
+    if (_routed != this) { return; }
+    Wire.end();
+    _routed = nullptr;
+}
+
+bool WireBus::onRecover() {
+    // The controller drives the pins while routed; take them back
+    if (_routed) {
+        Wire.end();
+        _routed = nullptr;
+    }
+    if (_port_alt) { return clearLines(PIN_SDA_ALT, PIN_SCL_ALT); }
+    return clearLines(PIN_SDA, PIN_SCL);
+}
+
+bool WireBus::transmit(const uint8_t address, const uint8_t* const src,
+                       const uint8_t length) {
+    route();
+    if (auto&& writer = Wire.get_writer(address)) {
+        for (uint8_t i = 0; i < length; ++i) { writer << src[i]; }
+        return true;
+    }
+    return false;
+}
+
+bool WireBus::receive(const uint8_t address, uint8_t* const dst, const uint8_t length) {
+    route();
+    if (auto&& reader = Wire.get_reader(address, length)) {
+        for (uint8_t i = 0; i < length; ++i) { reader >> dst[i]; }
+        return true;
+    }
+    return false;
+}
+
+// MARK: WireBus (private)
+
+void WireBus::route() {
+    if (_routed == this) { return; }
+    if (_routed) { Wire.end(); }
+    Wire.begin(getSpeed() == Speed::STANDARD ? WIRE_CONF::WIRE_100KHZ :
+                                               WIRE_CONF::WIRE_400KHZ,
+               _port_alt);
+    _routed = this;
+}
+
+// MARK: SoftwareI2CBus (protected)
+
+bool SoftwareI2CBus::onBegin() {
+    return clearLines(_sda, _scl);
+}
+
+void SoftwareI2CBus::onSpeedChange() {
+    _half_period = getHalfPeriod(getSpeed());
+}
+
+void SoftwareI2CBus::onEnd() {
+    releaseLine(_sda);
+    releaseLine(_scl);
+}
+
+bool SoftwareI2CBus::transmit(const uint8_t address, const uint8_t* const src,
+                              const uint8_t length) {
+    bool acked = start() and writeByte(address << 1);
+    for (uint8_t i = 0; acked and i < length; ++i) { acked = writeByte(src[i]); }
+    stop();
+    return acked;
+}
+
+bool SoftwareI2CBus::receive(const uint8_t address, uint8_t* const dst,
+                             const uint8_t length) {
+    const bool acked = start() and writeByte((address << 1) | 1);
+    if (acked) {
+        for (uint8_t i = 0; i < length; ++i) { dst[i] = readByte(i + 1 < length); }
+    }
+    stop();
+    return acked;
+}
+
+// MARK: SoftwareI2CBus (private)
+
+bool SoftwareI2CBus::releaseClock() {
+    releaseLine(_scl);
+    for (uint16_t waited = 0; digitalRead(_scl) == PIN_STATE::LOW; ++waited) {
+        if (waited >= STRETCH_TIMEOUT) { return false; }
+        delayMicroseconds(1);
+    }
+    return true;
+}
+
+bool SoftwareI2CBus::start() {
+    releaseLine(_sda);
+    if (not releaseClock()) { return false; }
+    wait();
+    pullLine(_sda);
+    wait();
+    pullLine(_scl);
+    if (getSpeed() != Speed::HIGH_SPEED) { return true; }
+
+    // Master code at Fast-mode timing; no device acknowledges it
+    _half_period = getHalfPeriod(Speed::FAST);
+    writeByte(HS_MASTER_CODE);
+    _half_period = getHalfPeriod(Speed::HIGH_SPEED);
+    // Repeated START; devices stay in High-speed mode until the STOP
+    releaseLine(_sda);
+    wait();
+    if (not releaseClock()) { return false; }
+    wait();
+    pullLine(_sda);
+    wait();
+    pullLine(_scl);
+    return true;
+}
+
+void SoftwareI2CBus::stop() {
+    pullLine(_sda);
+    wait();
+    releaseClock();
+    wait();
+    releaseLine(_sda);
+    wait();
+}
+
+bool SoftwareI2CBus::writeByte(const uint8_t byte) {
+    for (int bit = 7; bit >= 0; --bit) {
+        if ((byte >> bit) & 1) {
+            releaseLine(_sda);
+        } else {
+            pullLine(_sda);
+        }
+        wait();
+        if (not releaseClock()) { return false; }
+        wait();
+        pullLine(_scl);
+    }
+    releaseLine(_sda);
+    wait();
+    if (not releaseClock()) { return false; }
+    const bool acked = digitalRead(_sda) == PIN_STATE::LOW;
+    wait();
+    pullLine(_scl);
+    return acked;
+}
+
+uint8_t SoftwareI2CBus::readByte(const bool ack) {
+    uint8_t byte = 0;
+    releaseLine(_sda);
+    for (int bit = 0; bit < 8; ++bit) {
+        wait();
+        releaseClock();
+        byte = (byte << 1) | (digitalRead(_sda) == PIN_STATE::HIGH ? 1 : 0);
+        wait();
+        pullLine(_scl);
+    }
+    if (ack) { pullLine(_sda); }
+    wait();
+    releaseClock();
+    wait();
+    pullLine(_scl);
+    releaseLine(_sda);
+    return byte;
+}
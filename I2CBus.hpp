@@ -0,0 +1,517 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   I2CBus.hpp
+ * @brief  I2C bus handles shared by the device drivers.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class I2CBus
+ * @brief Interface for an I2C bus used by one or more device drivers.
+ *
+ * Drivers hold a reference to a bus instead of calling the global `Wire`, so sensors
+ * can be spread over several buses. The bus is reference counted: it is started by
+ * the first `acquire()` and stopped by the last `release()`, so stopping one driver
+ * does not reset the bus under the others.
+ *
+ * Implementations provide the `onBegin()`, `onEnd()`, `onRecover()`, `transmit()`
+ * and `receive()` primitives; the public methods are shared by all buses.
+ */
+class I2CBus {
+public:
+    // MARK: Settings (public)
+
+    /**
+     * @brief Enum class for I2C clock speeds.
+     *
+     * A transaction runs at the fastest speed allowed by both the device and the bus.
+     */
+    enum class Speed : uint8_t {
+        STANDARD,      ///< Standard-mode, 100 kHz
+        FAST,          ///< Fast-mode, 400 kHz
+        FAST_PLUS,     ///< Fast-mode Plus, 1 MHz
+        HIGH_SPEED,    ///< High-speed mode, 3.4 MHz (entered with a master code)
+    };
+
+    /**
+     * @brief Converts the `Speed` enum to its underlying type.
+     * @param e The `Speed` value.
+     * @return The underlying value of the speed.
+     */
+    static constexpr int use(const Speed e) { return static_cast<int>(e); }
+
+    /// Number of speeds
+    static const int SPEEDS = static_cast<int>(Speed::HIGH_SPEED) + 1;
+
+    /**
+     * @brief Traffic counters of one speed.
+     */
+    struct Stats {
+        uint32_t transactions;    ///< Transactions (START to STOP)
+        uint32_t bytes;           ///< Bytes on the wire, including address bytes
+        uint32_t time;            ///< Time spent in transactions (us)
+    };
+
+    /**
+     * @brief Error counters of the bus.
+     */
+    struct Errors {
+        uint32_t nacks;        ///< Attempts not acknowledged
+        uint32_t retries;      ///< Attempts repeated after a NACK
+        uint32_t failures;     ///< Transactions failed after all retries
+    };
+
+    /// Longest wait before a retry (us)
+    static const uint16_t MAX_BACKOFF = 2000;
+
+private:
+    // MARK: Variables (private)
+
+    /// Number of drivers that acquired the bus
+    uint8_t _users;
+
+    /// Fastest speed allowed on the bus
+    Speed _max_speed;
+
+    /// Speed the bus is running at
+    Speed _speed;
+
+    /// Traffic counters per speed
+    Stats _stats[SPEEDS];
+
+    /// Error counters
+    Errors _errors;
+
+    /// Retries of a transaction after a NACK
+    uint8_t _retries;
+
+    /// Wait before the first retry, doubled for each further one (us)
+    uint16_t _backoff;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     *
+     * The bus runs in Standard-mode until a faster speed is allowed with
+     * `setMaxSpeed()`, and retries a transaction twice, after 100 us and 200 us.
+     */
+    I2CBus()
+        : _users(0), _max_speed(Speed::STANDARD), _speed(Speed::STANDARD), _stats {},
+          _errors {}, _retries(2), _backoff(100) {}
+
+    /**
+     * @brief Destructor for the bus.
+     */
+    virtual ~I2CBus() {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Register a user of the bus, starting the bus for the first one.
+     * @return `true` if the bus is running; otherwise, `false`.
+     */
+    bool acquire();
+
+    /**
+     * @brief Unregister a user of the bus, stopping the bus after the last one.
+     */
+    void release();
+
+    /**
+     * @brief Retrieves the number of registered users.
+     * @return The user count.
+     */
+    inline uint8_t getUsers() const { return _users; }
+
+    /**
+     * @brief Retrieves the fastest speed allowed on the bus.
+     * @return The speed limit of the bus.
+     */
+    inline Speed getMaxSpeed() const { return _max_speed; }
+
+    /**
+     * @brief Sets the fastest speed allowed on the bus.
+     *
+     * Limited to what the bus implementation supports. Every device on the bus
+     * must tolerate traffic at this speed, even when it is addressed more slowly.
+     *
+     * @param speed The speed limit of the bus.
+     */
+    void setMaxSpeed(const Speed speed);
+
+    /**
+     * @brief Retrieves the traffic counters of one speed.
+     * @param speed The speed.
+     * @return The counters since the last `clearStats()`.
+     */
+    inline const Stats& getStats(const Speed speed) const { return _stats[use(speed)]; }
+
+    /**
+     * @brief Retrieves the measured throughput of one speed.
+     * @param speed The speed.
+     * @return Bytes per second on the wire, or 0 if the speed was not used.
+     */
+    uint32_t getThroughput(const Speed speed) const;
+
+    /**
+     * @brief Reset the traffic and error counters.
+     */
+    void clearStats();
+
+    /**
+     * @brief Sets how a transaction that is not acknowledged is retried.
+     *
+     * A NACK from noise or a device briefly busy costs one repeated transaction
+     * instead of the whole operation of the driver. The wait doubles for each
+     * retry, up to `MAX_BACKOFF`. `probe()` is never retried.
+     *
+     * @param retries Retries after the first attempt; 0 disables retrying.
+     * @param backoff Wait before the first retry (us).
+     */
+    inline void setRetry(const uint8_t retries, const uint16_t backoff) {
+        _retries = retries;
+        _backoff = backoff;
+    }
+
+    /**
+     * @brief Retrieves the error counters.
+     * @return The counters since the last `clearStats()`.
+     */
+    inline const Errors& getErrors() const { return _errors; }
+
+    /**
+     * @brief Retrieves the share of attempts that were not acknowledged.
+     * @return NACKs per million attempts, over all speeds.
+     */
+    uint32_t getErrorRate() const;
+
+    /**
+     * @brief Write bytes to a device.
+     *
+     * @param address 7-bit device address.
+     * @param src Bytes to write.
+     * @param length Number of bytes.
+     * @param speed Fastest speed supported by the device.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool write(const uint8_t address, const uint8_t* const src, const uint8_t length,
+               const Speed speed = Speed::STANDARD);
+
+    /**
+     * @brief Read bytes from a device.
+     *
+     * @param address 7-bit device address.
+     * @param dst Destination of the bytes.
+     * @param length Number of bytes.
+     * @param speed Fastest speed supported by the device.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool read(const uint8_t address, uint8_t* const dst, const uint8_t length,
+              const Speed speed = Speed::STANDARD);
+
+    /**
+     * @brief Write a register address, then read bytes starting from it.
+     *
+     * @param address 7-bit device address.
+     * @param reg Register address.
+     * @param dst Destination of the bytes.
+     * @param length Number of bytes.
+     * @param speed Fastest speed supported by the device.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool readRegister(const uint8_t address, const uint8_t reg, uint8_t* const dst,
+                      const uint8_t length, const Speed speed = Speed::STANDARD);
+
+    /**
+     * @brief Check whether a device acknowledges its address.
+     * @param address 7-bit device address.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool probe(const uint8_t address);
+
+    /**
+     * @brief Free a bus held by a device.
+     *
+     * A device reset or interrupted in the middle of a read keeps SDA low and
+     * blocks every transaction. Up to nine clocks let it finish the byte, then a
+     * STOP returns it to idle.
+     *
+     * @return `true` if SDA is released; otherwise, `false`.
+     */
+    inline bool recover() { return onRecover(); }
+
+    /**
+     * @brief Retrieves the bus used by drivers that were not given one.
+     * @return The hardware I2C bus on the default pins.
+     */
+    static I2CBus& getDefault();
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    /**
+     * @brief Retrieves the speed the bus is running at.
+     * @return The current speed.
+     */
+    inline Speed getSpeed() const { return _speed; }
+
+    /**
+     * @brief Retrieves the fastest speed the implementation supports.
+     * @return The speed capability of the bus.
+     */
+    virtual Speed getCapability() const = 0;
+
+    /**
+     * @brief Change the clock of a running bus; `getSpeed()` returns the new speed.
+     */
+    virtual void onSpeedChange() = 0;
+
+    /**
+     * @brief Start the bus hardware.
+     * @return `true` on success; otherwise, `false`.
+     */
+    virtual bool onBegin() = 0;
+
+    /**
+     * @brief Stop the bus hardware.
+     */
+    virtual void onEnd() = 0;
+
+    /**
+     * @brief Clock out a device holding SDA and leave the bus idle.
+     * @return `true` if SDA is released; otherwise, `false`.
+     */
+    virtual bool onRecover() = 0;
+
+    /**
+     * @brief Send a START, the address with the write bit, the bytes, then a STOP.
+     * @return `true` if every byte was acknowledged; otherwise, `false`.
+     */
+    virtual bool transmit(const uint8_t address, const uint8_t* const src,
+                          const uint8_t length) = 0;
+
+    /**
+     * @brief Send a START, the address with the read bit, read the bytes, then a STOP.
+     * @return `true` if the address was acknowledged; otherwise, `false`.
+     */
+    virtual bool receive(const uint8_t address, uint8_t* const dst,
+                         const uint8_t length) = 0;
+
+    /**
+     * @brief Clock out a device holding SDA, then send a STOP, on GPIO pins.
+     *
+     * @param sda Data pin.
+     * @param scl Clock pin.
+     * @return `true` if SDA is released; otherwise, `false`.
+     */
+    static bool clearLines(const uint8_t sda, const uint8_t scl);
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Switch to the fastest speed allowed by both the device and the bus.
+     * @param speed Fastest speed supported by the device.
+     */
+    void select(const Speed speed);
+
+    /**
+     * @brief Write bytes to a device once, without retrying.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool writeOnce(const uint8_t address, const uint8_t* const src,
+                   const uint8_t length, const Speed speed);
+
+    /**
+     * @brief Read bytes from a device once, without retrying.
+     * @return `true` if the device acknowledged; otherwise, `false`.
+     */
+    bool readOnce(const uint8_t address, uint8_t* const dst, const uint8_t length,
+                  const Speed speed);
+
+    /**
+     * @brief Count a failed attempt and wait before the next one.
+     * @param attempt Number of the failed attempt, from 0.
+     * @return `true` to retry; `false` if the retries are used up.
+     */
+    bool backoff(const uint8_t attempt);
+
+    /**
+     * @brief Add one transaction to the counters of the current speed.
+     * @param length Data bytes of the transaction.
+     * @param started Time the transaction started (us).
+     */
+    void count(const uint8_t length, const uint32_t started);
+};
+
+/**
+ * @class WireBus
+ * @brief I2C bus on the hardware controller of the TWELITE (`Wire`).
+ *
+ * The TWELITE has one I2C controller that can be routed to the default pins or to
+ * the alternative pins. A `WireBus` is created for each pin set in use; the bus
+ * that is accessed re-routes the controller if the other one was used last, so two
+ * buses take turns on the one controller.
+ *
+ * The controller runs up to Fast-mode (400 kHz).
+ */
+class WireBus : public I2CBus {
+public:
+    // MARK: Constants (public)
+
+    /// Data pin of the controller
+    static const uint8_t PIN_SDA = 15;
+
+    /// Clock pin of the controller
+    static const uint8_t PIN_SCL = 14;
+
+    /// Alternative data pin of the controller
+    static const uint8_t PIN_SDA_ALT = 17;
+
+    /// Alternative clock pin of the controller
+    static const uint8_t PIN_SCL_ALT = 16;
+
+private:
+    // MARK: Variables (private)
+
+    /// `true` to use the alternative pins
+    bool _port_alt;
+
+    /// Bus currently routed to the controller
+    static WireBus* _routed;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     * @param port_alt `true` to use the alternative pins.
+     */
+    WireBus(const bool port_alt = false) : _port_alt(port_alt) {}
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    inline Speed getCapability() const override { return Speed::FAST; }
+    void onSpeedChange() override;
+    bool onBegin() override;
+    void onEnd() override;
+    bool onRecover() override;
+    bool transmit(const uint8_t address, const uint8_t* const src,
+                  const uint8_t length) override;
+    bool receive(const uint8_t address, uint8_t* const dst,
+                 const uint8_t length) override;
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Route the controller to this bus if another bus was used last.
+     */
+    void route();
+};
+
+/**
+ * @class SoftwareI2CBus
+ * @brief I2C bus bit-banged on two GPIO pins.
+ *
+ * Open-drain lines are emulated by switching a pin between output low and input
+ * with pull-up; add external pull-up resistors for anything but short wires.
+ * Clock stretching by the device is honoured up to `STRETCH_TIMEOUT` microseconds.
+ * The bus is independent of the hardware controller, so a slow sensor can be moved
+ * here and leave `Wire` to the fast ones.
+ *
+ * All speeds are accepted; the faster ones drop the delays between edges and run
+ * as fast as the GPIO can toggle. High-speed transactions start with the master
+ * code at Fast-mode timing, followed by a repeated START, as the I2C specification
+ * requires.
+ */
+class SoftwareI2CBus : public I2CBus {
+public:
+    // MARK: Constants (public)
+
+    /// Longest clock stretching accepted (us)
+    static const uint16_t STRETCH_TIMEOUT = 1000;
+
+    /// Master code announcing a High-speed transaction (0000 1xxx)
+    static const uint8_t HS_MASTER_CODE = 0x08;
+
+private:
+    // MARK: Variables (private)
+
+    /// Data pin
+    uint8_t _sda;
+
+    /// Clock pin
+    uint8_t _scl;
+
+    /// Half of the clock period at the current speed (us)
+    uint16_t _half_period;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     *
+     * @param sda Data pin.
+     * @param scl Clock pin.
+     */
+    SoftwareI2CBus(const uint8_t sda, const uint8_t scl)
+        : _sda(sda), _scl(scl), _half_period(getHalfPeriod(Speed::STANDARD)) {}
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    inline Speed getCapability() const override { return Speed::HIGH_SPEED; }
+    void onSpeedChange() override;
+    bool onBegin() override;
+    void onEnd() override;
+    inline bool onRecover() override { return clearLines(_sda, _scl); }
+    bool transmit(const uint8_t address, const uint8_t* const src,
+                  const uint8_t length) override;
+    bool receive(const uint8_t address, uint8_t* const dst,
+                 const uint8_t length) override;
+
+private:
+    // MARK: Line utils (private)
+
+    inline void releaseLine(const uint8_t pin) { pinMode(pin, PIN_MODE::INPUT_PULLUP); }
+    inline void pullLine(const uint8_t pin) {
+        digitalWrite(pin, PIN_STATE::LOW);
+        pinMode(pin, PIN_MODE::OUTPUT);
+    }
+    inline void wait() const {
+        if (_half_period > 0) { delayMicroseconds(_half_period); }
+    }
+
+    /**
+     * @brief Retrieves the half clock period for a speed.
+     * @param speed The speed.
+     * @return Half of the clock period (us); 0 runs at the GPIO limit.
+     */
+    static constexpr uint16_t getHalfPeriod(const Speed speed) {
+        return speed == Speed::STANDARD ? 5 : speed == Speed::FAST ? 2 : 0;
+    }
+
+    bool releaseClock();
+    bool start();
+    void stop();
+    bool writeByte(const uint8_t byte);
+    uint8_t readByte(const bool ack);
+};
@@ -0,0 +1,280 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   OutlierFilter.hpp
+ * @brief  Running median and MAD-based spike rejection for sensor outputs.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @struct OutlierDeviation
+ * @brief Type holding the deviations and rejection limit of `T` samples.
+ *
+ * 64 bits for integers, so that the distance between two samples and the scaled
+ * MAD of 32-bit samples do not overflow.
+ */
+template <typename T>
+struct OutlierDeviation {
+    typedef int64_t type;
+};
+
+/**
+ * @struct OutlierDeviation<float>
+ * @brief Type holding the deviations and rejection limit of `float` samples.
+ */
+template <>
+struct OutlierDeviation<float> {
+    typedef float type;
+};
+
+/**
+ * @struct OutlierDeviation<double>
+ * @brief Type holding the deviations and rejection limit of `double` samples.
+ */
+template <>
+struct OutlierDeviation<double> {
+    typedef double type;
+};
+
+/**
+ * @class OutlierFilter
+ * @brief Running median with median absolute deviation (MAD) spike rejection.
+ *
+ * Keeps the last `N` samples both in arrival order and in sorted order, so the
+ * median and the MAD of the window are available after every sample without any
+ * allocation. Each new sample is judged against the window *before* it is inserted
+ * (a causal Hampel filter): if it deviates from the median by more than
+ * `threshold * 1.4826 * MAD`, the median is emitted in its place.
+ *
+ * The work per sample is bounded by the window size (at most 15), so the cost is
+ * constant for a given instantiation.
+ *
+ * @tparam T Sample type (e.g. `float` for `DPS310`, `int16_t` for `ADS1x1x`).
+ * @tparam N Window size; must be odd and within 3 to 15.
+ */
+template <typename T, int N>
+class OutlierFilter {
+    static_assert(N >= 3 and N <= 15, "Window size must be within 3 to 15");
+    static_assert(N % 2 == 1, "Window size must be odd");
+
+    typedef typename OutlierDeviation<T>::type Deviation;
+
+public:
+    // MARK: Constants (public)
+
+    /**
+     * @brief Default rejection threshold in 1/16 units of the scaled MAD.
+     *
+     * 3 sigma, where sigma is estimated as 1.4826 * MAD: 3 * 1.4826 * 16 = 71.
+     */
+    static const int DEFAULT_THRESHOLD_X16 = 71;
+
+private:
+    // MARK: Variables (private)
+
+    /// Samples in arrival order (ring buffer)
+    T _ring[N];
+
+    /// Samples in ascending order
+    T _sorted[N];
+
+    /// Number of valid samples in the window
+    int _count;
+
+    /// Index of the oldest sample in `_ring`
+    int _head;
+
+    /// Rejection threshold multiplier for the MAD, in 1/16 units
+    int _threshold_x16;
+
+    /// Smallest deviation that may be rejected, guards against MAD = 0
+    T _min_deviation;
+
+    /// Number of samples replaced by the median
+    uint32_t _rejected_count;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the filter.
+     *
+     * @param threshold_x16 Rejection threshold for the MAD in 1/16 units
+     * (default: 3 sigma).
+     * @param min_deviation Deviations below this value are never rejected.
+     */
+    OutlierFilter(const int threshold_x16 = DEFAULT_THRESHOLD_X16,
+                  const T min_deviation = T())
+        : _ring { T() }, _sorted { T() }, _count(0), _head(0),
+          _threshold_x16(threshold_x16), _min_deviation(min_deviation),
+          _rejected_count(0) {}
+
+public:
+    // MARK: Set/Get (public)
+
+    /**
+     * @brief Sets the rejection threshold.
+     * @param threshold_x16 Multiplier for the MAD in 1/16 units.
+     */
+    inline void setThreshold(const int threshold_x16) { _threshold_x16 = threshold_x16; }
+
+    /**
+     * @brief Sets the smallest deviation that may be rejected.
+     * @param min_deviation Deviation floor in sample units.
+     */
+    inline void setMinDeviation(const T min_deviation) { _min_deviation = min_deviation; }
+
+    /**
+     * @brief Retrieves the number of samples replaced so far.
+     * @return The count of rejected samples.
+     */
+    inline uint32_t getRejectedCount() const { return _rejected_count; }
+
+    /**
+     * @brief Checks if the window is completely filled.
+     * @return `true` once `N` samples have been pushed; otherwise, `false`.
+     */
+    inline bool isFilled() const { return _count == N; }
+
+    /**
+     * @brief Retrieves the median of the current window.
+     * @return The median, or `T()` if the window is empty.
+     */
+    inline T median() const { return _count > 0 ? _sorted[_count / 2] : T(); }
+
+    /**
+     * @brief Retrieves the median absolute deviation of the current window.
+     *
+     * The deviations of a sorted window grow outward from the median on both
+     * sides, so the k-th smallest one is found by merging the two sides.
+     *
+     * @return The MAD, or `T()` if the window is empty.
+     */
+    T mad() const {
+        if (_count == 0) { return T(); }
+        const int mid = _count / 2;
+        const T m = _sorted[mid];
+        int lo = mid - 1, hi = mid + 1;
+        T deviation = T();    // _sorted[mid] itself
+        for (int k = 0; k < mid; ++k) {
+            if (hi >= _count or (lo >= 0 and m - _sorted[lo] <= _sorted[hi] - m)) {
+                deviation = m - _sorted[lo--];
+            } else {
+                deviation = _sorted[hi++] - m;
+            }
+        }
+        return deviation;
+    }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Filter a sample.
+     *
+     * Judges the sample against the current window, writes either the sample or
+     * the window median to `out`, then inserts the sample into the window. Until
+     * the window is filled, samples are passed through unchanged.
+     *
+     * @param in The new sample.
+     * @param out Pointer to store the filtered sample.
+     * @return `true` if the sample was accepted; `false` if it was replaced.
+     */
+    bool process(const T in, T* const out) {
+        bool accepted = true;
+        if (isFilled()) {
+            const T m = median();
+            const Deviation deviation = in > m ? static_cast<Deviation>(in) - m :
+                                                 static_cast<Deviation>(m) - in;
+            Deviation limit = static_cast<Deviation>(mad()) * _threshold_x16 / 16;
+            if (limit < _min_deviation) { limit = _min_deviation; }
+            if (deviation > limit) { accepted = false; }
+            *out = accepted ? in : m;
+        } else {
+            *out = in;
+        }
+        if (not accepted) { ++_rejected_count; }
+        push(in);
+        return accepted;
+    }
+
+    /**
+     * @brief Insert a sample into the window without judging it.
+     *
+     * Evicts the oldest sample once the window is filled.
+     *
+     * @param in The new sample.
+     */
+    void push(const T in) {
+        if (isFilled()) {
+            erase(_ring[_head]);
+            _ring[_head] = in;
+            _head = (_head + 1) % N;
+        } else {
+            _ring[(_head + _count) % N] = in;
+        }
+        insert(in);
+    }
+
+    /**
+     * @brief Clear the window and the rejection counter.
+     */
+    void reset() {
+        _count = 0;
+        _head = 0;
+        _rejected_count = 0;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Find the first position in the sorted window not less than a value.
+     * @param value The value to search for.
+     * @return Index in `_sorted` within `[0, _count]`.
+     */
+    int lowerBound(const T value) const {
+        int lo = 0, hi = _count;
+        while (lo < hi) {
+            const int mid = (lo + hi) / 2;
+            if (_sorted[mid] < value) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Insert a value into the sorted window.
+     * @param value The value to insert.
+     */
+    void insert(const T value) {
+        int i = _count;
+        const int pos = lowerBound(value);
+        for (; i > pos; --i) { _sorted[i] = _sorted[i - 1]; }
+        _sorted[pos] = value;
+        ++_count;
+    }
+
+    /**
+     * @brief Remove one occurrence of a value from the sorted window.
+     * @param value The value to remove; must be present.
+     */
+    void erase(const T value) {
+        int i = lowerBound(value);
+        for (--_count; i < _count; ++i) { _sorted[i] = _sorted[i + 1]; }
+    }
+};
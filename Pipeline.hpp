@@ -0,0 +1,420 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   Pipeline.hpp
+ * @brief  Compile-time chain of measurement processing stages.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "OutlierFilter.hpp"
+#include "Varint.hpp"
+
+/*
+ * A stage is any class that provides:
+ * - `input_type` and `output_type` typedefs,
+ * - `bool feed(const input_type in, output_type* const out)`, which returns `true`
+ *   when `out` holds a value to pass to the next stage,
+ * - `void reset()`.
+ *
+ * Stages are held by value and called directly, so the compiler sees the whole
+ * chain and can inline it into the loop that reads the driver.
+ */
+
+// MARK: Pipeline
+
+template <typename... Stages>
+class Pipeline;
+
+/**
+ * @struct PipelineElement
+ * @brief Type and accessor of the `I`-th stage of a pipeline.
+ *
+ * @tparam I Stage index from the source side.
+ * @tparam P Pipeline type.
+ */
+template <int I, typename P>
+struct PipelineElement;
+
+/**
+ * @class Pipeline
+ * @brief Chain of stages fed by a driver.
+ *
+ * `Pipeline<A, B, C>` passes every value fed to it through `A`, then `B`, then `C`.
+ * A stage that does not emit (decimation, report-on-change, ...) ends the pass.
+ * All buffers live inside the stages; nothing is allocated.
+ *
+ * @tparam Head First stage.
+ * @tparam Tail Remaining stages.
+ */
+template <typename Head, typename... Tail>
+class Pipeline<Head, Tail...> {
+public:
+    /// Type accepted by the first stage
+    typedef typename Head::input_type input_type;
+
+    /// Type produced by the last stage
+    typedef typename Pipeline<Tail...>::output_type output_type;
+
+private:
+    /// First stage
+    Head _head;
+
+    /// Remaining stages
+    Pipeline<Tail...> _tail;
+
+public:
+    /**
+     * @brief Pass a value through the chain.
+     *
+     * @param in The value from the source.
+     * @param out Pointer to store the value produced by the last stage.
+     * @return `true` if the last stage produced a value; otherwise, `false`.
+     */
+    inline bool feed(const input_type in, output_type* const out) {
+        typename Head::output_type mid;
+        return _head.feed(in, &mid) and _tail.feed(mid, out);
+    }
+
+    /**
+     * @brief Reset every stage.
+     */
+    inline void reset() {
+        _head.reset();
+        _tail.reset();
+    }
+
+    /**
+     * @brief Retrieves a stage for configuration or inspection.
+     * @tparam I Stage index from the source side.
+     * @return A reference to the stage.
+     */
+    template <int I>
+    inline typename PipelineElement<I, Pipeline>::type& stage() {
+        return PipelineElement<I, Pipeline>::get(*this);
+    }
+
+    /// First stage.
+    inline Head& head() { return _head; }
+
+    /// Remaining stages.
+    inline Pipeline<Tail...>& tail() { return _tail; }
+};
+
+/**
+ * @class Pipeline
+ * @brief Chain consisting of its last stage.
+ *
+ * @tparam Last The last stage.
+ */
+template <typename Last>
+class Pipeline<Last> {
+public:
+    /// Type accepted by the stage
+    typedef typename Last::input_type input_type;
+
+    /// Type produced by the stage
+    typedef typename Last::output_type output_type;
+
+private:
+    /// The stage
+    Last _head;
+
+public:
+    /// @copydoc Pipeline::feed
+    inline bool feed(const input_type in, output_type* const out) {
+        return _head.feed(in, out);
+    }
+
+    /// @copydoc Pipeline::reset
+    inline void reset() { _head.reset(); }
+
+    /// @copydoc Pipeline::stage
+    template <int I>
+    inline typename PipelineElement<I, Pipeline>::type& stage() {
+        return PipelineElement<I, Pipeline>::get(*this);
+    }
+
+    /// The stage.
+    inline Last& head() { return _head; }
+};
+
+template <typename Head, typename... Tail>
+struct PipelineElement<0, Pipeline<Head, Tail...>> {
+    typedef Head type;
+    static inline type& get(Pipeline<Head, Tail...>& p) { return p.head(); }
+};
+
+template <int I, typename Head, typename... Tail>
+struct PipelineElement<I, Pipeline<Head, Tail...>> {
+    typedef typename PipelineElement<I - 1, Pipeline<Tail...>>::type type;
+    static inline type& get(Pipeline<Head, Tail...>& p) {
+        return PipelineElement<I - 1, Pipeline<Tail...>>::get(p.tail());
+    }
+};
+
+// MARK: Stages
+
+/**
+ * @class DecimateStage
+ * @brief Averages every `N` samples into one.
+ *
+ * @tparam T Sample type.
+ * @tparam N Decimation factor.
+ * @tparam Acc Accumulator type; use a wider integer than `T` for integer samples.
+ */
+template <typename T, int N, typename Acc = T>
+class DecimateStage {
+    static_assert(N >= 1, "Decimation factor must be positive");
+
+public:
+    typedef T input_type;
+    typedef T output_type;
+
+private:
+    Acc _sum;      ///< Sum of the samples in the current block
+    int _count;    ///< Number of samples in the current block
+
+public:
+    DecimateStage() : _sum(), _count(0) {}
+
+    inline bool feed(const T in, T* const out) {
+        _sum += in;
+        if (++_count < N) { return false; }
+        *out = static_cast<T>(_sum / N);
+        reset();
+        return true;
+    }
+
+    inline void reset() {
+        _sum = Acc();
+        _count = 0;
+    }
+};
+
+/**
+ * @class MedianStage
+ * @brief Replaces spikes with the running median (see `OutlierFilter`).
+ *
+ * @tparam T Sample type.
+ * @tparam N Window size; must be odd and within 3 to 15.
+ */
+template <typename T, int N>
+class MedianStage {
+public:
+    typedef T input_type;
+    typedef T output_type;
+
+private:
+    OutlierFilter<T, N> _filter;    ///< Underlying filter
+
+public:
+    inline bool feed(const T in, T* const out) {
+        _filter.process(in, out);
+        return true;
+    }
+
+    inline void reset() { _filter.reset(); }
+
+    /// Underlying filter, for thresholds and counters.
+    inline OutlierFilter<T, N>& filter() { return _filter; }
+};
+
+/**
+ * @class IirStage
+ * @brief First-order low-pass filter, y += (x - y) / 2^SHIFT.
+ *
+ * The state is kept scaled by 2^SHIFT, so integer samples do not lose the
+ * fractional part of the filtered value.
+ *
+ * @tparam T Sample type.
+ * @tparam SHIFT Smoothing factor as a power of two (time constant ~ 2^SHIFT samples).
+ * @tparam Acc State type; use a wider integer than `T` for integer samples.
+ */
+template <typename T, int SHIFT, typename Acc = T>
+class IirStage {
+    static_assert(SHIFT >= 0 and SHIFT < 16, "Shift must be within 0 to 15");
+
+public:
+    typedef T input_type;
+    typedef T output_type;
+
+private:
+    Acc _state;      ///< Filtered value scaled by 2^SHIFT
+    bool _primed;    ///< `true` once the first sample has been seen
+
+public:
+    IirStage() : _state(), _primed(false) {}
+
+    inline bool feed(const T in, T* const out) {
+        if (_primed) {
+            _state += static_cast<Acc>(in) - _state / (1 << SHIFT);
+        } else {
+            _state = static_cast<Acc>(in) * (1 << SHIFT);
+            _primed = true;
+        }
+        *out = static_cast<T>(_state / (1 << SHIFT));
+        return true;
+    }
+
+    inline void reset() {
+        _state = Acc();
+        _primed = false;
+    }
+};
+
+/**
+ * @class ChangeStage
+ * @brief Report-on-change with a deadband and a heartbeat.
+ *
+ * Passes a value when it differs from the last passed value by at least the
+ * deadband, or when `heartbeat` samples have been suppressed in a row.
+ *
+ * @tparam T Sample type.
+ */
+template <typename T>
+class ChangeStage {
+public:
+    typedef T input_type;
+    typedef T output_type;
+
+private:
+    T _deadband;            ///< Smallest change that is reported
+    uint16_t _heartbeat;    ///< Report at least every this many samples (0: never)
+    uint16_t _skipped;      ///< Samples suppressed since the last report
+    T _last;                ///< Last reported value
+    bool _primed;           ///< `true` once a value has been reported
+
+public:
+    ChangeStage() : _deadband(), _heartbeat(0), _skipped(0), _last(), _primed(false) {}
+
+    /**
+     * @brief Configure the stage.
+     * @param deadband Smallest change that is reported.
+     * @param heartbeat Report at least every this many samples (0: never).
+     */
+    inline void setup(const T deadband, const uint16_t heartbeat = 0) {
+        _deadband = deadband;
+        _heartbeat = heartbeat;
+    }
+
+    inline bool feed(const T in, T* const out) {
+        const T change = in > _last ? in - _last : _last - in;
+        if (_primed and change < _deadband
+            and (_heartbeat == 0 or _skipped + 1 < _heartbeat)) {
+            ++_skipped;
+            return false;
+        }
+        _primed = true;
+        _skipped = 0;
+        _last = in;
+        *out = in;
+        return true;
+    }
+
+    inline void reset() {
+        _skipped = 0;
+        _primed = false;
+    }
+};
+
+/**
+ * @class QuantizeStage
+ * @brief Converts a value to a fixed-point integer, round(in * SCALE).
+ *
+ * Use this in front of `DeltaEncodeStage` for floating point sources, e.g.
+ * `QuantizeStage<float, int32_t, 100>` turns hPa from `DPS310` into Pa.
+ *
+ * @tparam T Input type.
+ * @tparam Out Integer output type.
+ * @tparam SCALE Scale factor.
+ */
+template <typename T, typename Out, int SCALE>
+class QuantizeStage {
+public:
+    typedef T input_type;
+    typedef Out output_type;
+
+    inline bool feed(const T in, Out* const out) {
+        const T scaled = in * SCALE;
+        *out = static_cast<Out>(scaled < 0 ? scaled - T(1) / 2 : scaled + T(1) / 2);
+        return true;
+    }
+
+    inline void reset() {}
+};
+
+/**
+ * @struct EncodedSample
+ * @brief Bytes produced by `DeltaEncodeStage` for one sample.
+ */
+struct EncodedSample {
+    uint8_t length;                         ///< Number of valid bytes
+    uint8_t bytes[Varint::MAX_LENGTH];      ///< Varint coded ZigZag delta
+};
+
+/**
+ * @class DeltaEncodeStage
+ * @brief Encodes each integer sample as a varint delta from the previous one.
+ *
+ * The first sample after a reset is coded against zero, so a decoder that starts
+ * from zero at the same point reproduces the series exactly.
+ *
+ * @tparam T Integer sample type.
+ */
+template <typename T>
+class DeltaEncodeStage {
+public:
+    typedef T input_type;
+    typedef EncodedSample output_type;
+
+private:
+    T _previous;    ///< Previous sample
+
+public:
+    DeltaEncodeStage() : _previous() {}
+
+    inline bool feed(const T in, EncodedSample* const out) {
+        const int32_t delta = static_cast<int32_t>(in) - static_cast<int32_t>(_previous);
+        out->length = static_cast<uint8_t>(Varint::encode(Varint::zigzag(delta), out->bytes));
+        _previous = in;
+        return true;
+    }
+
+    inline void reset() { _previous = T(); }
+};
+
+/**
+ * @class SinkStage
+ * @brief Hands every value to a function chosen at compile time.
+ *
+ * The function is a template argument rather than a stored pointer, so the call
+ * is direct and can be inlined.
+ *
+ * @tparam T Value type.
+ * @tparam F Function to call with each value.
+ */
+template <typename T, void (*F)(const T&)>
+class SinkStage {
+public:
+    typedef T input_type;
+    typedef T output_type;
+
+    inline bool feed(const T in, T* const out) {
+        F(in);
+        *out = in;
+        return true;
+    }
+
+    inline void reset() {}
+};
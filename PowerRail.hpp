@@ -0,0 +1,149 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   PowerRail.hpp
+ * @brief  GPIO-switched supply of a sensor, with on-time accounting.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class PowerRail
+ * @brief Switches the supply of a sensor through an enable pin.
+ *
+ * A driver that owns a rail turns it on for each measurement and off as soon as
+ * the result is read out of the sensor. The time between the two is added to
+ * the on-time, so the energy spent per sample can be compared between settings.
+ *
+ * Without a pin the rail is always on and nothing is counted.
+ */
+class PowerRail {
+public:
+    // MARK: Constants (public)
+
+    /// Pin number meaning no enable pin
+    static const uint8_t NO_PIN = 0xFF;
+
+private:
+    // MARK: Variables (private)
+
+    /// Enable pin, or `NO_PIN`
+    uint8_t _pin;
+
+    /// `true` if the rail is on while the pin is high
+    bool _active_high;
+
+    /// `true` while the rail is on
+    bool _on;
+
+    /// Time the rail was turned on (us)
+    uint32_t _on_at;
+
+    /// On-time of the latest cycle (us)
+    uint32_t _last;
+
+    /// Total on-time (us)
+    uint32_t _total;
+
+    /// Number of on/off cycles
+    uint32_t _cycles;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the rail.
+     */
+    PowerRail()
+        : _pin(NO_PIN), _active_high(true), _on(true), _on_at(0), _last(0), _total(0),
+          _cycles(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Setup the enable pin; the rail is left off.
+     *
+     * @param pin Enable pin, or `NO_PIN` for an always-on supply.
+     * @param active_high `true` if the rail is on while the pin is high.
+     */
+    inline void setup(const uint8_t pin, const bool active_high = true) {
+        _pin = pin;
+        _active_high = active_high;
+        _on = not isGated();
+        if (not isGated()) { return; }
+        drive(false);
+        pinMode(_pin, PIN_MODE::OUTPUT);
+    }
+
+    /**
+     * @brief Turn the rail on; does nothing if it is on.
+     */
+    inline void on() {
+        if (_on) { return; }
+        drive(true);
+        _on = true;
+        _on_at = micros();
+    }
+
+    /**
+     * @brief Turn the rail off and count its on-time; does nothing if it is off or
+     * not gated.
+     */
+    inline void off() {
+        if (not _on or not isGated()) { return; }
+        drive(false);
+        _on = false;
+        _last = micros() - _on_at;
+        _total += _last;
+        ++_cycles;
+    }
+
+    /// `true` if the rail is switched by a pin.
+    inline bool isGated() const { return _pin != NO_PIN; }
+
+    /// `true` while the rail is on.
+    inline bool isOn() const { return _on; }
+
+    /// Time the rail was turned on (us, as `micros()`).
+    inline uint32_t getOnSince() const { return _on_at; }
+
+    /// On-time of the latest cycle (us).
+    inline uint32_t getLastOnTime() const { return _last; }
+
+    /// Total on-time (us).
+    inline uint32_t getTotalOnTime() const { return _total; }
+
+    /// Number of on/off cycles.
+    inline uint32_t getCycles() const { return _cycles; }
+
+    /**
+     * @brief Clears the on-time counters.
+     */
+    inline void clear() {
+        _last = 0;
+        _total = 0;
+        _cycles = 0;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Set the level of the enable pin.
+     * @param enable `true` to turn the rail on.
+     */
+    inline void drive(const bool enable) {
+        digitalWrite(_pin, enable == _active_high ? PIN_STATE::HIGH : PIN_STATE::LOW);
+    }
+};
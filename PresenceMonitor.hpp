@@ -0,0 +1,136 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   PresenceMonitor.hpp
+ * @brief  Detection of a device unplugged from the bus and of its return.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class PresenceMonitor
+ * @brief Decides when a device is absent and when to look for it again.
+ *
+ * The driver reports each request with `hit()` if the device answered, or with
+ * `miss()` if it failed because the device did not respond. After `ABSENT_AFTER`
+ * consecutive misses the device is taken as absent; the driver then stops
+ * talking to it, except for a cheap presence probe whenever `due()` says so.
+ *
+ * Probes start `MIN_INTERVAL` apart and the interval doubles after each probe
+ * that finds nothing, up to `MAX_INTERVAL`, so a probe that stays unplugged
+ * costs almost no bus time.
+ *
+ * All times are in milliseconds.
+ */
+class PresenceMonitor {
+public:
+    // MARK: Constants (public)
+
+    /// Consecutive misses after which the device is absent
+    static const uint8_t ABSENT_AFTER = 3;
+
+    /// Interval between the first probes (ms)
+    static const uint32_t MIN_INTERVAL = 20;
+
+    /// Longest interval between probes (ms)
+    static const uint32_t MAX_INTERVAL = 5000;
+
+private:
+    // MARK: Variables (private)
+
+    /// Consecutive requests the device did not answer
+    uint8_t _misses;
+
+    /// Interval to the next probe (ms)
+    uint32_t _interval;
+
+    /// Time of the latest probe, or of the detection (ms)
+    uint32_t _probed_at;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the monitor.
+     */
+    PresenceMonitor() : _misses(0), _interval(MIN_INTERVAL), _probed_at(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Report a request the device answered.
+     */
+    inline void hit() { _misses = 0; }
+
+    /**
+     * @brief Report a request that failed because the device did not respond.
+     * @param now Current time, as `millis()`.
+     * @return `true` if the device is now taken as absent; otherwise, `false`.
+     */
+    inline bool miss(const uint32_t now) {
+        if (_misses + 1 < ABSENT_AFTER) {
+            ++_misses;
+            return false;
+        }
+        lost(now);
+        return true;
+    }
+
+    /**
+     * @brief Take the device as absent at once, e.g. when it did not answer at boot.
+     * @param now Current time, as `millis()`.
+     */
+    inline void lost(const uint32_t now) {
+        _misses = ABSENT_AFTER;
+        _interval = MIN_INTERVAL;
+        _probed_at = now;
+    }
+
+    /**
+     * @brief Check whether the next presence probe is due, and mark it as taken.
+     * @param now Current time, as `millis()`.
+     * @return `true` if the driver should probe now; otherwise, `false`.
+     */
+    inline bool due(const uint32_t now) {
+        if (now - _probed_at < _interval) { return false; }
+        _probed_at = now;
+        return true;
+    }
+
+    /**
+     * @brief Report a probe that found nothing; the next one comes later.
+     */
+    inline void backoff() {
+        _interval = _interval * 2 < MAX_INTERVAL ? _interval * 2 : MAX_INTERVAL;
+    }
+
+    /**
+     * @brief Report a probe that found the device still starting up.
+     */
+    inline void retrySoon() { _interval = MIN_INTERVAL; }
+
+    /**
+     * @brief Report that the device is back.
+     */
+    inline void found() {
+        _misses = 0;
+        _interval = MIN_INTERVAL;
+    }
+
+    /// `true` while the device is taken as absent.
+    inline bool isAbsent() const { return _misses >= ABSENT_AFTER; }
+
+    /// Interval to the next probe (ms).
+    inline uint32_t getInterval() const { return _interval; }
+};
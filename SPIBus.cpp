@@ -0,0 +1,113 @@
+// -*- coding:utf-8-unix -*-
+
+#include "SPIBus.hpp"
+
+// MARK: SPIBus (public)
+
+bool SPIBus::acquire() {
+    if (_users == 0 and not onBegin()) { return false; }
+    ++_users;
+    return true;
+}
+
+void SPIBus::release() {
+    if (_users == 0) { return; }
+    if (--_users == 0) { onEnd(); }
+}
+
+bool SPIBus::transfer(const uint8_t device, const uint8_t* const src,
+                      const uint8_t src_length, uint8_t* const dst,
+                      const uint8_t dst_length) {
+    if (not select(device)) { return false; }
+    send(src, src_length);
+    if (dst) { receive(dst, dst_length); }
+    deselect();
+    return true;
+}
+
+// MARK: HardwareSPIBus (protected)
+
+bool HardwareSPIBus::onBegin() {
+    _slot = NO_SLOT;
+    return true;
+}
+
+void HardwareSPIBus::onEnd() {
+    if (_slot == NO_SLOT) { return; }
+    SPI.end();
+    _slot = NO_SLOT;
+}
+
+bool HardwareSPIBus::select(const uint8_t device) {
+    if (device != _slot) {
+        // The controller is bound to one slot at a time
+        if (_slot != NO_SLOT) { SPI.end(); }
+        SPI.begin(device, SPISettings(_frequency, SPI_CONF::MSBFIRST, _mode));
+        _slot = device;
+    }
+    SPI.beginTransaction();
+    return true;
+}
+
+void HardwareSPIBus::deselect() {
+    SPI.endTransaction();
+}
+
+void HardwareSPIBus::send(const uint8_t* const src, const uint8_t length) {
+    for (uint8_t i = 0; i < length; ++i) { SPI.transfer(src[i]); }
+}
+
+void HardwareSPIBus::receive(uint8_t* const dst, const uint8_t length) {
+    for (uint8_t i = 0; i < length; ++i) { dst[i] = SPI.transfer(0xFF); }
+}
+
+// MARK: SoftwareSPIBus (protected)
+
+bool SoftwareSPIBus::onBegin() {
+    pinMode(_sck, PIN_MODE::OUTPUT_INIT_HIGH);
+    pinMode(_mosi, PIN_MODE::OUTPUT_INIT_HIGH);
+    if (_miso != _mosi) { pinMode(_miso, PIN_MODE::INPUT_PULLUP); }
+    return true;
+}
+
+void SoftwareSPIBus::onEnd() {
+    pinMode(_sck, PIN_MODE::INPUT);
+    pinMode(_mosi, PIN_MODE::INPUT);
+}
+
+bool SoftwareSPIBus::select(const uint8_t device) {
+    _selected = device;
+    pinMode(_selected, PIN_MODE::OUTPUT_INIT_HIGH);
+    pinMode(_mosi, PIN_MODE::OUTPUT);
+    digitalWrite(_selected, PIN_STATE::LOW);
+    return true;
+}
+
+void SoftwareSPIBus::deselect() {
+    digitalWrite(_selected, PIN_STATE::HIGH);
+}
+
+void SoftwareSPIBus::send(const uint8_t* const src, const uint8_t length) {
+    for (uint8_t i = 0; i < length; ++i) {
+        for (int bit = 7; bit >= 0; --bit) {
+            // Mode 3: change data on the falling edge, sample on the rising edge
+            digitalWrite(_sck, PIN_STATE::LOW);
+            digitalWrite(_mosi, ((src[i] >> bit) & 1) ? PIN_STATE::HIGH : PIN_STATE::LOW);
+            digitalWrite(_sck, PIN_STATE::HIGH);
+        }
+    }
+}
+
+void SoftwareSPIBus::receive(uint8_t* const dst, const uint8_t length) {
+    // On a 3-wire bus the device drives the shared data pin from here on
+    if (isThreeWire()) { pinMode(_mosi, PIN_MODE::INPUT); }
+    for (uint8_t i = 0; i < length; ++i) {
+        uint8_t byte = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            digitalWrite(_sck, PIN_STATE::LOW);
+            digitalWrite(_sck, PIN_STATE::HIGH);
+            byte = (byte << 1) | (digitalRead(_miso) == PIN_STATE::HIGH ? 1 : 0);
+        }
+        dst[i] = byte;
+    }
+}
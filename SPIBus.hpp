@@ -0,0 +1,224 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   SPIBus.hpp
+ * @brief  SPI bus handles shared by the device drivers.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class SPIBus
+ * @brief Interface for an SPI bus used by one or more device drivers.
+ *
+ * Reference counted in the same way as `I2CBus`. A transaction selects a device,
+ * sends a header (command and register address), receives the reply and
+ * deselects the device again; this matches the register access of sensors such as
+ * the DPS310.
+ *
+ * Implementations provide the `onBegin()`, `onEnd()`, `select()`, `deselect()`,
+ * `send()` and `receive()` primitives.
+ */
+class SPIBus {
+private:
+    // MARK: Variables (private)
+
+    /// Number of drivers that acquired the bus
+    uint8_t _users;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     */
+    SPIBus() : _users(0) {}
+
+    /**
+     * @brief Destructor for the bus.
+     */
+    virtual ~SPIBus() {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Register a user of the bus, starting the bus for the first one.
+     * @return `true` if the bus is running; otherwise, `false`.
+     */
+    bool acquire();
+
+    /**
+     * @brief Unregister a user of the bus, stopping the bus after the last one.
+     */
+    void release();
+
+    /**
+     * @brief Retrieves the number of registered users.
+     * @return The user count.
+     */
+    inline uint8_t getUsers() const { return _users; }
+
+    /**
+     * @brief Send bytes to a device, then receive its reply, in one selection.
+     *
+     * @param device Device selection (chip select pin or controller slot).
+     * @param src Bytes to send.
+     * @param src_length Number of bytes to send.
+     * @param dst Destination of the reply, or `nullptr`.
+     * @param dst_length Number of bytes to receive.
+     * @return `true` on success; otherwise, `false`.
+     */
+    bool transfer(const uint8_t device, const uint8_t* const src,
+                  const uint8_t src_length, uint8_t* const dst, const uint8_t dst_length);
+
+    /**
+     * @brief Check whether the bus shares one data line for both directions.
+     * @return `true` for a 3-wire bus; `false` for a 4-wire bus.
+     */
+    virtual bool isThreeWire() const = 0;
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    /**
+     * @brief Start the bus hardware.
+     * @return `true` on success; otherwise, `false`.
+     */
+    virtual bool onBegin() = 0;
+
+    /**
+     * @brief Stop the bus hardware.
+     */
+    virtual void onEnd() = 0;
+
+    /**
+     * @brief Select a device.
+     * @return `true` on success; otherwise, `false`.
+     */
+    virtual bool select(const uint8_t device) = 0;
+
+    /**
+     * @brief Deselect the device selected last.
+     */
+    virtual void deselect() = 0;
+
+    /**
+     * @brief Clock bytes out to the selected device.
+     */
+    virtual void send(const uint8_t* const src, const uint8_t length) = 0;
+
+    /**
+     * @brief Clock bytes in from the selected device.
+     */
+    virtual void receive(uint8_t* const dst, const uint8_t length) = 0;
+};
+
+/**
+ * @class HardwareSPIBus
+ * @brief 4-wire SPI bus on the hardware controller of the TWELITE (`SPI`).
+ *
+ * The controller drives the select lines itself; `device` is the controller slot
+ * (0 to 2). The controller is restarted when another slot is selected.
+ */
+class HardwareSPIBus : public SPIBus {
+private:
+    // MARK: Variables (private)
+
+    /// Clock frequency (Hz)
+    uint32_t _frequency;
+
+    /// Clock polarity and phase (`SPI_CONF::SPI_MODE0` to `SPI_MODE3`)
+    uint8_t _mode;
+
+    /// Slot the controller is started for, or `NO_SLOT`
+    uint8_t _slot;
+
+    /// Value of `_slot` while the controller is stopped
+    static const uint8_t NO_SLOT = 0xFF;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     *
+     * @param frequency Clock frequency (Hz).
+     * @param mode Clock polarity and phase (`SPI_CONF::SPI_MODE0` to `SPI_MODE3`).
+     */
+    HardwareSPIBus(const uint32_t frequency = 4000000,
+                   const uint8_t mode = SPI_CONF::SPI_MODE3)
+        : _frequency(frequency), _mode(mode), _slot(NO_SLOT) {}
+
+    inline bool isThreeWire() const override { return false; }
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    bool onBegin() override;
+    void onEnd() override;
+    bool select(const uint8_t device) override;
+    void deselect() override;
+    void send(const uint8_t* const src, const uint8_t length) override;
+    void receive(uint8_t* const dst, const uint8_t length) override;
+};
+
+/**
+ * @class SoftwareSPIBus
+ * @brief SPI bus bit-banged on GPIO pins, in mode 3 (clock idles high).
+ *
+ * `device` is the chip select pin of the device. Passing the same pin as `mosi`
+ * and `miso` makes a 3-wire bus, where the data pin turns around to input after
+ * the header.
+ */
+class SoftwareSPIBus : public SPIBus {
+private:
+    // MARK: Variables (private)
+
+    /// Clock pin
+    uint8_t _sck;
+
+    /// Data out pin (also data in on a 3-wire bus)
+    uint8_t _mosi;
+
+    /// Data in pin
+    uint8_t _miso;
+
+    /// Chip select pin of the selected device
+    uint8_t _selected;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the bus.
+     *
+     * @param sck Clock pin.
+     * @param mosi Data out pin.
+     * @param miso Data in pin; the same as `mosi` for a 3-wire bus.
+     */
+    SoftwareSPIBus(const uint8_t sck, const uint8_t mosi, const uint8_t miso)
+        : _sck(sck), _mosi(mosi), _miso(miso), _selected(0) {}
+
+    inline bool isThreeWire() const override { return _mosi == _miso; }
+
+protected:
+    // MARK: Bus primitives (protected)
+
+    bool onBegin() override;
+    void onEnd() override;
+    bool select(const uint8_t device) override;
+    void deselect() override;
+    void send(const uint8_t* const src, const uint8_t length) override;
+    void receive(uint8_t* const dst, const uint8_t length) override;
+};
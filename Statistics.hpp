@@ -0,0 +1,469 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   Statistics.hpp
+ * @brief  O(1) running statistics with tumbling and sliding windows.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @struct StatisticsSummary
+ * @brief Summary record of one channel over a window.
+ *
+ * Compact enough to be transmitted instead of the raw samples it describes.
+ *
+ * @tparam T Sample type.
+ */
+template <typename T>
+struct StatisticsSummary {
+    uint32_t count;    ///< Number of samples in the window
+    T min;             ///< Smallest sample
+    T max;             ///< Largest sample
+    T last;            ///< Most recent sample
+    float mean;        ///< Arithmetic mean
+    float variance;    ///< Sample variance (divided by count - 1)
+};
+
+/**
+ * @struct StatisticsAccumulator
+ * @brief Mean and variance accumulator for integer samples.
+ *
+ * Sums of the shifted data: samples are offset by the first sample of the run, and
+ * their sum and sum of squares are kept in 64-bit integers. Adding and removing a
+ * sample costs two integer multiply-adds, is exact, and keeps the sums small while
+ * the data stays close to the first sample. Floating point is only used when a
+ * result is queried.
+ *
+ * `float` and `double` samples use `FloatStatisticsAccumulator` instead.
+ *
+ * @tparam T Integer sample type (e.g. raw `ADS1x1x` counts).
+ */
+template <typename T>
+struct StatisticsAccumulator {
+    uint32_t count;    ///< Number of accumulated samples
+    T shift;           ///< Offset subtracted from every sample
+    int64_t sum;       ///< Sum of shifted samples
+    int64_t sum_sq;    ///< Sum of squared shifted samples
+
+    /// Discard all samples.
+    inline void clear() {
+        count = 0;
+        shift = T();
+        sum = 0;
+        sum_sq = 0;
+    }
+
+    /// Add a sample.
+    inline void add(const T x) {
+        if (count == 0) { shift = x; }
+        const int64_t d = static_cast<int64_t>(x) - shift;
+        sum += d;
+        sum_sq += d * d;
+        ++count;
+    }
+
+    /// Remove a sample that was previously added.
+    inline void remove(const T x) {
+        if (count <= 1) {
+            clear();
+            return;
+        }
+        const int64_t d = static_cast<int64_t>(x) - shift;
+        sum -= d;
+        sum_sq -= d * d;
+        --count;
+    }
+
+    /// Arithmetic mean of the accumulated samples.
+    inline float mean() const {
+        if (count == 0) { return 0.0f; }
+        return static_cast<float>(shift + static_cast<double>(sum) / count);
+    }
+
+    /// Sample variance of the accumulated samples.
+    inline float variance() const {
+        if (count < 2) { return 0.0f; }
+        // Both terms grow with the distance from the shift and cancel; a float
+        // keeps only 24 bits of them
+        const double s = static_cast<double>(sum);
+        const double v = (static_cast<double>(sum_sq) - s * s / count) / (count - 1);
+        return v > 0.0 ? static_cast<float>(v) : 0.0f;
+    }
+};
+
+/**
+ * @struct FloatStatisticsAccumulator
+ * @brief Mean and variance accumulator for floating point samples.
+ *
+ * Classic Welford update of the mean and the sum of squared deviations, with the
+ * matching downdate for removing samples from a sliding window.
+ *
+ * @tparam F Floating point type of the running mean and sum of squares.
+ */
+template <typename F>
+struct FloatStatisticsAccumulator {
+    uint32_t count;    ///< Number of accumulated samples
+    F mu;              ///< Running mean
+    F m2;              ///< Sum of squared deviations from the mean
+
+    /// Discard all samples.
+    inline void clear() {
+        count = 0;
+        mu = F();
+        m2 = F();
+    }
+
+    /// Add a sample.
+    inline void add(const F x) {
+        ++count;
+        const F delta = x - mu;
+        mu += delta / count;
+        m2 += delta * (x - mu);
+    }
+
+    /// Remove a sample that was previously added.
+    inline void remove(const F x) {
+        if (count <= 1) {
+            clear();
+            return;
+        }
+        const F delta = x - mu;
+        --count;
+        mu -= delta / count;
+        m2 -= delta * (x - mu);
+        if (m2 < F()) { m2 = F(); }
+    }
+
+    /// Arithmetic mean of the accumulated samples.
+    inline float mean() const { return static_cast<float>(mu); }
+
+    /// Sample variance of the accumulated samples.
+    inline float variance() const {
+        return count < 2 ? 0.0f : static_cast<float>(m2 / (count - 1));
+    }
+};
+
+/**
+ * @struct StatisticsAccumulator<float>
+ * @brief Mean and variance accumulator for `float` samples.
+ *
+ * Accumulates in `double`: around 1013 hPa a float mean resolves only about 6e-5,
+ * and each downdate of a sliding window leaves rounding in the sum of squares that
+ * builds up without bound over a long run.
+ */
+template <>
+struct StatisticsAccumulator<float> : FloatStatisticsAccumulator<double> {};
+
+/**
+ * @struct StatisticsAccumulator<double>
+ * @brief Mean and variance accumulator for `double` samples.
+ */
+template <>
+struct StatisticsAccumulator<double> : FloatStatisticsAccumulator<double> {};
+
+/**
+ * @class RunningStatistics
+ * @brief Cumulative statistics of one channel since the last reset.
+ *
+ * Tracks count, min, max, mean, variance and the last sample in O(1) per sample.
+ *
+ * @tparam T Sample type (e.g. `float` for `DPS310`, `int16_t` for `ADS1x1x`).
+ */
+template <typename T>
+class RunningStatistics {
+private:
+    // MARK: Variables (private)
+
+    /// Mean and variance accumulator
+    StatisticsAccumulator<T> _acc;
+
+    /// Smallest sample
+    T _min;
+
+    /// Largest sample
+    T _max;
+
+    /// Most recent sample
+    T _last;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the statistics.
+     */
+    RunningStatistics() { reset(); }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Add a sample.
+     * @param x The new sample.
+     */
+    void push(const T x) {
+        if (_acc.count == 0 or x < _min) { _min = x; }
+        if (_acc.count == 0 or x > _max) { _max = x; }
+        _last = x;
+        _acc.add(x);
+    }
+
+    /**
+     * @brief Discard all samples.
+     */
+    void reset() {
+        _acc.clear();
+        _min = _max = _last = T();
+    }
+
+    /**
+     * @brief Retrieves the number of samples since the last reset.
+     * @return The sample count.
+     */
+    inline uint32_t getCount() const { return _acc.count; }
+
+    /**
+     * @brief Build a summary of the samples since the last reset.
+     * @return The summary record.
+     */
+    StatisticsSummary<T> summary() const {
+        StatisticsSummary<T> s;
+        s.count = _acc.count;
+        s.min = _min;
+        s.max = _max;
+        s.last = _last;
+        s.mean = _acc.mean();
+        s.variance = _acc.variance();
+        return s;
+    }
+};
+
+/**
+ * @class TumblingStatistics
+ * @brief Statistics over consecutive, non-overlapping windows.
+ *
+ * A window is closed after a fixed number of samples or a fixed period, and its
+ * summary is kept until the next window closes. Use this to send one summary
+ * record per minute instead of every sample.
+ *
+ * @tparam T Sample type.
+ */
+template <typename T>
+class TumblingStatistics {
+public:
+    // MARK: Settings (public)
+
+    /**
+     * @brief Enum class for the unit of the window length.
+     */
+    enum class WindowUnit : uint8_t {
+        SAMPLES,        ///< Window length counted in samples
+        MILLISECONDS    ///< Window length counted in milliseconds
+    };
+
+private:
+    // MARK: Variables (private)
+
+    /// Statistics of the open window
+    RunningStatistics<T> _current;
+
+    /// Summary of the last closed window
+    StatisticsSummary<T> _closed;
+
+    /// Window length
+    uint32_t _length;
+
+    /// Unit of the window length
+    WindowUnit _unit;
+
+    /// Start time of the open window (ms)
+    uint32_t _start_time;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the tumbling window.
+     *
+     * @param length Window length.
+     * @param unit Unit of the window length (default: SAMPLES).
+     */
+    TumblingStatistics(const uint32_t length,
+                       const WindowUnit unit = WindowUnit::SAMPLES)
+        : _closed(RunningStatistics<T>().summary()), _length(length), _unit(unit),
+          _start_time(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Add a sample.
+     *
+     * For time-based windows, the window is closed when a sample arrives after the
+     * period has elapsed; that sample opens the next window.
+     *
+     * @param x The new sample.
+     * @param now Current time in milliseconds (only used for MILLISECONDS windows).
+     * @return `true` if a window was closed and a new summary is available.
+     */
+    bool push(const T x, const uint32_t now = 0) {
+        bool closed = false;
+        if (_unit == WindowUnit::MILLISECONDS) {
+            if (_current.getCount() > 0 and now - _start_time >= _length) {
+                flush();
+                closed = true;
+            }
+            if (_current.getCount() == 0) { _start_time = now; }
+        }
+        _current.push(x);
+        if (_unit == WindowUnit::SAMPLES and _current.getCount() >= _length) {
+            flush();
+            closed = true;
+        }
+        return closed;
+    }
+
+    /**
+     * @brief Close the open window immediately.
+     */
+    void flush() {
+        _closed = _current.summary();
+        _current.reset();
+    }
+
+    /**
+     * @brief Retrieves the summary of the last closed window.
+     * @return The summary record.
+     */
+    inline const StatisticsSummary<T>& getSummary() const { return _closed; }
+
+    /**
+     * @brief Retrieves the statistics of the open window.
+     * @return The running statistics.
+     */
+    inline const RunningStatistics<T>& getCurrent() const { return _current; }
+};
+
+/**
+ * @class SlidingStatistics
+ * @brief Statistics over the last `N` samples.
+ *
+ * The mean and variance are downdated as samples leave the window, and the min and
+ * max are kept in monotonic queues, so every sample costs amortized O(1).
+ *
+ * @tparam T Sample type.
+ * @tparam N Window size in samples.
+ */
+template <typename T, int N>
+class SlidingStatistics {
+    static_assert(N >= 1, "Window size must be positive");
+
+private:
+    // MARK: Variables (private)
+
+    /**
+     * @brief Monotonic double-ended queue of ring positions.
+     */
+    struct Deque {
+        int pos[N];    ///< Ring positions of candidate samples, oldest first
+        int head;      ///< Index of the front element
+        int size;      ///< Number of elements
+
+        inline int front() const { return pos[head]; }
+        inline int back() const { return pos[(head + size - 1) % N]; }
+        inline void popFront() {
+            head = (head + 1) % N;
+            --size;
+        }
+        inline void popBack() { --size; }
+        inline void pushBack(const int p) { pos[(head + size++) % N] = p; }
+    };
+
+    /// Samples in arrival order
+    T _ring[N];
+
+    /// Ring position of the next sample
+    int _next;
+
+    /// Mean and variance accumulator
+    StatisticsAccumulator<T> _acc;
+
+    /// Candidates for the window minimum, increasing values
+    Deque _min_q;
+
+    /// Candidates for the window maximum, decreasing values
+    Deque _max_q;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the sliding window.
+     */
+    SlidingStatistics() { reset(); }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Add a sample, evicting the oldest one once the window is filled.
+     * @param x The new sample.
+     */
+    void push(const T x) {
+        if (_acc.count == static_cast<uint32_t>(N)) {
+            // The oldest sample occupies the position about to be overwritten
+            _acc.remove(_ring[_next]);
+            if (_min_q.size > 0 and _min_q.front() == _next) { _min_q.popFront(); }
+            if (_max_q.size > 0 and _max_q.front() == _next) { _max_q.popFront(); }
+        }
+        while (_min_q.size > 0 and not(_ring[_min_q.back()] < x)) { _min_q.popBack(); }
+        while (_max_q.size > 0 and not(_ring[_max_q.back()] > x)) { _max_q.popBack(); }
+        _ring[_next] = x;
+        _min_q.pushBack(_next);
+        _max_q.pushBack(_next);
+        _acc.add(x);
+        _next = (_next + 1) % N;
+    }
+
+    /**
+     * @brief Discard all samples.
+     */
+    void reset() {
+        _next = 0;
+        _acc.clear();
+        _min_q.head = _min_q.size = 0;
+        _max_q.head = _max_q.size = 0;
+    }
+
+    /**
+     * @brief Retrieves the number of samples in the window.
+     * @return The sample count, at most `N`.
+     */
+    inline uint32_t getCount() const { return _acc.count; }
+
+    /**
+     * @brief Build a summary of the samples in the window.
+     * @return The summary record.
+     */
+    StatisticsSummary<T> summary() const {
+        StatisticsSummary<T> s;
+        s.count = _acc.count;
+        s.min = _min_q.size > 0 ? _ring[_min_q.front()] : T();
+        s.max = _max_q.size > 0 ? _ring[_max_q.front()] : T();
+        s.last = _acc.count > 0 ? _ring[(_next + N - 1) % N] : T();
+        s.mean = _acc.mean();
+        s.variance = _acc.variance();
+        return s;
+    }
+};
@@ -0,0 +1,138 @@
+// -*- coding:utf-8-unix -*-
+
+#include "SyncFrame.hpp"
+
+// MARK: DPS310Source (public)
+
+bool DPS310Source::collect() {
+    if (not _sensor.available()) { return false; }
+    return _sensor.read(&_temperature, &_pressure) == DPS310::Result::SUCCESS;
+}
+
+void DPS310Source::discard() {
+    _sensor.update();
+    // The collected values belong to the frame; read into scratch
+    float temperature, pressure;
+    _sensor.read(&temperature, &pressure);
+}
+
+uint32_t DPS310Source::getNominalLead() const {
+    DPS310::Settings& settings = _sensor.getSettings();
+    // Whole temperature conversion, then half of the pressure conversion
+    return DPS310::getMeasurementTimeFor(settings.temperature_precision) * 1000
+        + DPS310::getMeasurementTimeFor(settings.pressure_precision) * 1000 / 2;
+}
+
+// MARK: ADS1x1xSource (public)
+
+bool ADS1x1xSource::collect() {
+    if (not _adc.available()) { return false; }
+    return _adc.read(&_voltage, &_raw) == ADS1x1x::Result::SUCCESS;
+}
+
+void ADS1x1xSource::discard() {
+    _adc.update();
+    // The collected values belong to the frame; read into scratch
+    uint16_t voltage;
+    int16_t raw;
+    _adc.read(&voltage, &raw);
+}
+
+uint32_t ADS1x1xSource::getNominalLead() const {
+    return 500000 / ADS1x1x::use(_adc.getSettings().data_rate);
+}
+
+// MARK: SyncFrame (public)
+
+bool SyncFrame::add(SyncSource& source) {
+    if (_count >= MAX_SOURCES) { return false; }
+    _slots[_count].source = &source;
+    _slots[_count].lead = source.getNominalLead();
+    ++_count;
+    return true;
+}
+
+bool SyncFrame::request() {
+    if (not in(State::IDLE) or _count == 0) { return false; }
+    uint32_t longest = 0;
+    for (int i = 0; i < _count; ++i) {
+        if (_slots[i].lead > longest) { longest = _slots[i].lead; }
+    }
+    _started = micros();
+    // Give up on a source well after the slowest one should have delivered
+    _timeout = longest * 4 + 50000;
+    for (int i = 0; i < _count; ++i) {
+        _slots[i].trigger_at = _started + (longest - _slots[i].lead);
+        _slots[i].requested = false;
+        _slots[i].collected = false;
+    }
+    set(State::BUSY);
+    update();
+    return true;
+}
+
+void SyncFrame::update() {
+    if (not in(State::BUSY)) { return; }
+    bool done = true;
+    for (int i = 0; i < _count; ++i) {
+        if (_slots[i].collected) { continue; }
+        done = false;
+        const uint32_t now = micros();
+        if (not _slots[i].requested) {
+            if (static_cast<int32_t>(now - _slots[i].trigger_at) < 0) { continue; }
+            if (not _slots[i].source->request()) {
+                // Still busy with a conversion given up by an earlier frame
+                _slots[i].source->discard();
+                continue;
+            }
+            _slots[i].requested = true;
+            _slots[i].requested_at = now;
+            continue;
+        }
+        _slots[i].source->update();
+        if (not _slots[i].source->collect()) { continue; }
+        _slots[i].collected = true;
+        // Refine the lead with the measured one (1/4 weight)
+        const uint32_t sampled = _slots[i].source->getTimestamp();
+        const int32_t measured = static_cast<int32_t>(sampled - _slots[i].requested_at);
+        if (measured > 0) {
+            _slots[i].lead += (measured - static_cast<int32_t>(_slots[i].lead)) / 4;
+        }
+    }
+    if (done or micros() - _started >= _timeout) { complete(); }
+}
+
+bool SyncFrame::read(uint32_t* const timestamp, uint32_t* const skew) {
+    if (not in(State::AVAILABLE)) { return false; }
+    *timestamp = _timestamp;
+    *skew = _skew;
+    set(State::IDLE);
+    return true;
+}
+
+// MARK: Specific utils (private)
+
+void SyncFrame::complete() {
+    _missing = 0;
+    int collected = 0;
+    uint32_t reference = 0;
+    int32_t earliest = 0, latest = 0;
+    int64_t sum = 0;
+    for (int i = 0; i < _count; ++i) {
+        if (not _slots[i].collected) {
+            ++_missing;
+            continue;
+        }
+        const uint32_t timestamp = _slots[i].source->getTimestamp();
+        if (collected == 0) { reference = timestamp; }
+        // Offsets from the first timestamp stay valid across the micros() wrap
+        const int32_t offset = static_cast<int32_t>(timestamp - reference);
+        if (offset < earliest) { earliest = offset; }
+        if (offset > latest) { latest = offset; }
+        sum += offset;
+        ++collected;
+    }
+    _timestamp = collected > 0 ? reference + static_cast<int32_t>(sum / collected) : 0;
+    _skew = static_cast<uint32_t>(latest - earliest);
+    set(State::AVAILABLE);
+}
@@ -0,0 +1,329 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   SyncFrame.hpp
+ * @brief  Synchronized acquisition of several sensors into one timestamped frame.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+#include "ADS1x1x.hpp"
+#include "DPS310.hpp"
+
+/**
+ * @class SyncSource
+ * @brief Adapter between a driver and `SyncFrame`.
+ *
+ * An adapter starts one conversion of its driver, keeps the result of that
+ * conversion and reports when it was sampled.
+ */
+class SyncSource {
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Destructor for the source.
+     */
+    virtual ~SyncSource() {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Start one conversion.
+     * @return `true` if the conversion was started; otherwise, `false`.
+     */
+    virtual bool request() = 0;
+
+    /**
+     * @brief Update the driver; called periodically while a conversion runs.
+     */
+    virtual void update() = 0;
+
+    /**
+     * @brief Take the result of the conversion if it is ready.
+     * @return `true` if the result was taken; otherwise, `false`.
+     */
+    virtual bool collect() = 0;
+
+    /**
+     * @brief Update the driver of a conversion the frame gave up on, and drop its
+     * result, so that the next `request()` is accepted.
+     */
+    virtual void discard() = 0;
+
+    /**
+     * @brief Retrieves when the collected result was sampled.
+     * @return The midpoint of the conversion (us, as `micros()`).
+     */
+    virtual uint32_t getTimestamp() const = 0;
+
+    /**
+     * @brief Retrieves the expected time from `request()` to the conversion midpoint.
+     * @return The nominal lead (us); `SyncFrame` refines it from measurements.
+     */
+    virtual uint32_t getNominalLead() const = 0;
+};
+
+/**
+ * @class DPS310Source
+ * @brief `SyncSource` for the pressure of a `DPS310`.
+ *
+ * The sample instant is the midpoint of the pressure conversion, which follows
+ * the temperature conversion of the same request.
+ */
+class DPS310Source : public SyncSource {
+private:
+    // MARK: Variables (private)
+
+    /// The sensor
+    DPS310& _sensor;
+
+    /// Collected temperature (°C)
+    float _temperature;
+
+    /// Collected pressure (hPa)
+    float _pressure;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the source.
+     * @param sensor The sensor, set up and begun by the application.
+     */
+    DPS310Source(DPS310& sensor) : _sensor(sensor), _temperature(0), _pressure(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    inline bool request() override {
+        return _sensor.request() == DPS310::Result::SUCCESS;
+    }
+    inline void update() override { _sensor.update(); }
+    bool collect() override;
+    void discard() override;
+    inline uint32_t getTimestamp() const override { return _sensor.getTimestamp(); }
+    uint32_t getNominalLead() const override;
+
+    /// Collected temperature (°C).
+    inline float getTemperature() const { return _temperature; }
+
+    /// Collected pressure (hPa).
+    inline float getPressure() const { return _pressure; }
+};
+
+/**
+ * @class ADS1x1xSource
+ * @brief `SyncSource` for one channel of an `ADS1x1x`.
+ */
+class ADS1x1xSource : public SyncSource {
+private:
+    // MARK: Variables (private)
+
+    /// The ADC
+    ADS1x1x& _adc;
+
+    /// Channel converted for the frame
+    ADS1x1x::ChannelConfig _channel;
+
+    /// Collected voltage (mV)
+    uint16_t _voltage;
+
+    /// Collected conversion result (counts)
+    int16_t _raw;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the source.
+     *
+     * @param adc The ADC, set up and begun by the application.
+     * @param channel Channel converted for the frame.
+     */
+    ADS1x1xSource(ADS1x1x& adc, const ADS1x1x::ChannelConfig channel)
+        : _adc(adc), _channel(channel), _voltage(0), _raw(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    inline bool request() override {
+        return _adc.request(_channel) == ADS1x1x::Result::SUCCESS;
+    }
+    inline void update() override { _adc.update(); }
+    bool collect() override;
+    void discard() override;
+    inline uint32_t getTimestamp() const override { return _adc.getTimestamp(); }
+    uint32_t getNominalLead() const override;
+
+    /// Collected voltage (mV).
+    inline uint16_t getVoltage() const { return _voltage; }
+
+    /// Collected conversion result (counts).
+    inline int16_t getRaw() const { return _raw; }
+};
+
+/**
+ * @class SyncFrame
+ * @brief Triggers registered sources so that their conversions are centred on one
+ * instant, and collects their results into one frame.
+ *
+ * Each source has a lead, the time from its request to the midpoint of its
+ * conversion. Sources with shorter leads are requested later, by the difference to
+ * the longest lead, so all midpoints fall on the same instant as far as the bus and
+ * the loop allow. Leads start from the nominal values of the adapters and are
+ * refined from the measured timestamps of every frame.
+ *
+ * The frame timestamp is the mean of the source timestamps; the skew is the spread
+ * between the earliest and the latest of them.
+ */
+class SyncFrame {
+public:
+    // MARK: Constants (public)
+
+    /// Maximum number of sources
+    static const int MAX_SOURCES = 8;
+
+private:
+    // MARK: States (private)
+
+    /**
+     * @brief Enumeration of internal states for the frame.
+     */
+    enum class State : int {
+        IDLE,       ///< No frame is being acquired.
+        BUSY,       ///< Sources are being triggered and collected.
+        AVAILABLE   ///< A frame is ready to be read.
+    };
+
+    /**
+     * @brief Sets the state of the frame.
+     * @param state The new state.
+     */
+    inline void set(const State state) { _state = state; }
+
+    /**
+     * @brief Checks if the frame is in a specific state.
+     * @param state The state to check.
+     * @return `true` if the frame is in the given state; otherwise, `false`.
+     */
+    inline bool in(const State state) { return _state == state; }
+
+private:
+    // MARK: Variables (private)
+
+    /// Current state of the frame
+    State _state;
+
+    /// Registered sources and their scheduling
+    struct {
+        SyncSource* source;     ///< The source
+        uint32_t lead;          ///< Learned lead (us)
+        uint32_t trigger_at;    ///< Time to request the source (us)
+        uint32_t requested_at;  ///< Time the source was requested (us)
+        bool requested;         ///< `true` once requested in this frame
+        bool collected;         ///< `true` once collected in this frame
+    } _slots[MAX_SOURCES];
+
+    /// Number of registered sources
+    uint8_t _count;
+
+    /// Time the frame was requested (us)
+    uint32_t _started;
+
+    /// Time after which a frame is delivered without the missing sources (us)
+    uint32_t _timeout;
+
+    /// Timestamp of the latest frame (us)
+    uint32_t _timestamp;
+
+    /// Skew of the latest frame (us)
+    uint32_t _skew;
+
+    /// Sources missing from the latest frame
+    uint8_t _missing;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the frame.
+     */
+    SyncFrame()
+        : _state(State::IDLE), _slots {}, _count(0), _started(0), _timeout(0),
+          _timestamp(0), _skew(0), _missing(0) {}
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Register a source.
+     * @param source The source; must outlive the frame.
+     * @return `true` if registered; `false` if `MAX_SOURCES` are registered.
+     */
+    bool add(SyncSource& source);
+
+    /**
+     * @brief Start acquiring a frame.
+     * @return `true` if started; `false` if busy or no source is registered.
+     */
+    bool request();
+
+    /**
+     * @brief Trigger the sources that are due and collect the results.
+     *
+     * Call as often as possible while a frame is acquired; the alignment is only as
+     * good as the polling interval.
+     *
+     * A source still converting for a frame that timed out is updated until it
+     * accepts the request, and its stale result is dropped.
+     */
+    void update();
+
+    /**
+     * @brief Check if a frame is available for reading.
+     * @return `true` if a frame is available; otherwise, `false`.
+     */
+    inline bool available() { return in(State::AVAILABLE); }
+
+    /**
+     * @brief Read the frame; the results are kept by the source adapters.
+     *
+     * @param timestamp Pointer to store the frame timestamp (us, as `micros()`).
+     * @param skew Pointer to store the spread of the source timestamps (us).
+     * @return `true` on success; `false` if no frame is available.
+     */
+    bool read(uint32_t* const timestamp, uint32_t* const skew);
+
+    /**
+     * @brief Retrieves the sources missing from the latest frame.
+     * @return The number of sources that did not deliver before the timeout.
+     */
+    inline uint8_t getMissing() const { return _missing; }
+
+    /**
+     * @brief Retrieves the learned lead of a source.
+     * @param index Registration index of the source.
+     * @return The lead (us).
+     */
+    inline uint32_t getLead(const int index) const { return _slots[index].lead; }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Compute the timestamp and skew and make the frame available.
+     */
+    void complete();
+};
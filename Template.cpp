@@ -13,7 +13,13 @@ void _DEVICE_::setup(const Address address, const Settings& settings) {
 
 void _DEVICE_::begin() {
     if (not in(State::WAIT_BEGIN)) { end(); }
-    Wire.begin();
+    if (not _bus_acquired) {
+        if (not _bus->acquire()) {
+            setError(Result::FAILED_NOT_RESPONDING);
+            return;
+        }
+        _bus_acquired = true;
+    }
     delay(50);    // Wait for device startup
     if (not softReset()) { return; }
     if (not applySomeSettings()) { return; }
@@ -43,8 +49,12 @@ void _DEVICE_::update() {
 }
 
 void _DEVICE_::end() {
+    if (_bus_acquired) {
+        // Other devices may still use the bus; it stops with its last user
+        _bus->release();
+        _bus_acquired = false;
+    }
     if (in(State::WAIT_BEGIN)) { return; }
-    Wire.end();
     set(State::WAIT_BEGIN);
 }
 
@@ -81,15 +91,7 @@ _DEVICE_::Result _DEVICE_::applySomeSettings() {
 // MARK: Common I2C utils (private)
 
 _DEVICE_::Result _DEVICE_::read(const Register reg, uint8_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-    } else {
-        setError(Result::FAILED_NOT_RESPONDING);
-        return _error;
-    }
-    if (auto&& reader = Wire.get_reader(use(_address), 1)) {
-        reader >> *dst;
-    } else {
+    if (not _bus->readRegister(use(_address), use(reg), dst, 1, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
@@ -97,34 +99,25 @@ _DEVICE_::Result _DEVICE_::read(const Register reg, uint8_t* const dst) {
 }
 
 _DEVICE_::Result _DEVICE_::read(const Register reg, uint16_t* const dst) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-    } else {
-        setError(Result::FAILED_NOT_RESPONDING);
-        return _error;
-    }
-    if (auto&& reader = Wire.get_reader(use(_address), 2)) {
-        uint8_t byte1, byte2;
-        reader >> byte1;
-        reader >> byte2;
-        *dst = (byte1 << 8) | byte2;
-    } else {
+    uint8_t bytes[2];
+    if (not _bus->readRegister(use(_address), use(reg), bytes, 2, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
+    *dst = (bytes[0] << 8) | bytes[1];
     return Result::SUCCESS;
 }
 
 _DEVICE_::Result _DEVICE_::write(const Register reg, const int src) {
-    if (auto&& writer = Wire.get_writer(use(_address))) {
-        writer << use(reg);
-        if (src <= 0xFF) {
-            writer << src;
-        } else {
-            writer << ((src >> 8) & 0xFF);
-            writer << (src & 0xFF);
-        }
+    uint8_t bytes[3] = { use(reg) };
+    uint8_t length = 1;
+    if (src <= 0xFF) {
+        bytes[length++] = src;
     } else {
+        bytes[length++] = (src >> 8) & 0xFF;
+        bytes[length++] = src & 0xFF;
+    }
+    if (not _bus->write(use(_address), bytes, length, _max_speed)) {
         setError(Result::FAILED_NOT_RESPONDING);
         return _error;
     }
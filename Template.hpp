@@ -17,6 +17,8 @@
  */
 #include <TWELITE>
 
+#include "I2CBus.hpp"
+
 /**
  * @class _DEVICE_
  * @brief Interface for the device.
@@ -246,6 +248,15 @@ private:
     /// I2C address of the device
     Address _address;
 
+    /// I2C bus the device is connected to
+    I2CBus* _bus;
+
+    /// `true` while the device holds a reference to the bus
+    bool _bus_acquired;
+
+    /// Fastest I2C speed supported by the device
+    I2CBus::Speed _max_speed;
+
     /// Configuration settings for the device
     Settings _settings;
 
@@ -266,6 +277,8 @@ public:
     _DEVICE_()
         : _state(State::WAIT_SETUP), _error(Result::FAILED_UNKNOWN),
           _error_message { 0 }, _address(Address::PRIMARY),
+          _bus(&I2CBus::getDefault()), _bus_acquired(false),
+          _max_speed(I2CBus::Speed::STANDARD),
           _settings(Settings(Settings::Presets::DEFAULT)),
           _values { 0 } {}
 
@@ -307,6 +320,44 @@ public:
      */
     inline void setAddress(const Address address) { _address = address; }
 
+    /**
+     * @brief Retrieves the I2C bus the device is connected to.
+     * @return A reference to the bus.
+     */
+    inline I2CBus& getBus() { return *_bus; }
+
+    /**
+     * @brief Sets the I2C bus the device is connected to.
+     *
+     * The hardware I2C bus on the default pins is used unless another bus is set.
+     * Call before `begin()`; a bus held by a running device is handed over.
+     *
+     * @param bus The bus to use.
+     */
+    inline void setBus(I2CBus& bus) {
+        if (_bus_acquired) {
+            _bus->release();
+            _bus_acquired = bus.acquire();
+        }
+        _bus = &bus;
+    }
+
+    /**
+     * @brief Retrieves the fastest I2C speed used for the device.
+     * @return The speed limit of the device.
+     */
+    inline I2CBus::Speed getMaxSpeed() const { return _max_speed; }
+
+    /**
+     * @brief Sets the fastest I2C speed used for the device.
+     *
+     * The transactions run at the fastest speed allowed by both this setting and the
+     * bus (see `I2CBus::setMaxSpeed()`).
+     *
+     * @param speed The speed limit of the device.
+     */
+    inline void setMaxSpeed(const I2CBus::Speed speed) { _max_speed = speed; }
+
     /**
      * @brief Retrieves the current device settings.
      *
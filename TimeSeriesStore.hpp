@@ -0,0 +1,301 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   TimeSeriesStore.hpp
+ * @brief  Fixed-memory multi-resolution time-series store for sensor channels.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @struct TimeSeriesSum
+ * @brief Accumulator type used to average `T` values.
+ *
+ * 64 bits, so that a sum of long rows of 32-bit integers does not overflow.
+ */
+template <typename T>
+struct TimeSeriesSum {
+    typedef int64_t type;
+};
+
+/**
+ * @struct TimeSeriesSum<float>
+ * @brief Accumulator type used to average `float` values.
+ */
+template <>
+struct TimeSeriesSum<float> {
+    typedef float type;
+};
+
+/**
+ * @struct TimeSeriesSum<double>
+ * @brief Accumulator type used to average `double` values.
+ */
+template <>
+struct TimeSeriesSum<double> {
+    typedef double type;
+};
+
+/**
+ * @class TimeSeriesStore
+ * @brief Round-robin store keeping recent samples raw and older ones as summaries.
+ *
+ * Level 0 keeps the last `SLOTS` samples of every channel at full resolution.
+ * Each of the `TIERS` summary levels keeps `SLOTS` rows of min, mean and max, where
+ * one row consolidates `factor` rows of the level below. With a 1 s sample period,
+ * 60 slots and factors {60, 60}, level 0 covers the last minute in seconds, level 1
+ * the last hour in minutes, and level 2 the last 60 hours in hours.
+ *
+ * Every column (one field of one channel at one level) is a contiguous array, so a
+ * query for one channel scans sequential memory. Memory use is fixed at compile
+ * time; nothing is allocated.
+ *
+ * Samples are expected at a fixed cadence: rows are counted, not timed. The end of
+ * the newest row of each level is derived from the time of the newest sample and
+ * the rows still pending below it (`getNewestRowTime()`).
+ *
+ * @tparam T Sample type.
+ * @tparam CHANNELS Number of channels.
+ * @tparam SLOTS Rows kept per level.
+ * @tparam TIERS Number of summary levels above the raw level.
+ */
+template <typename T, int CHANNELS, int SLOTS, int TIERS>
+class TimeSeriesStore {
+    static_assert(CHANNELS >= 1, "At least one channel is required");
+    static_assert(SLOTS >= 1, "At least one slot is required");
+    static_assert(TIERS >= 0, "Number of tiers must not be negative");
+
+    typedef typename TimeSeriesSum<T>::type Sum;
+
+public:
+    // MARK: Constants (public)
+
+    /// Number of levels including the raw level
+    static const int LEVELS = TIERS + 1;
+
+private:
+    // MARK: Variables (private)
+
+    /// Raw samples, one column per channel
+    T _raw[CHANNELS][SLOTS];
+
+    /// Row minimum per summary level and channel
+    T _min[TIERS > 0 ? TIERS : 1][CHANNELS][SLOTS];
+
+    /// Row mean per summary level and channel
+    T _mean[TIERS > 0 ? TIERS : 1][CHANNELS][SLOTS];
+
+    /// Row maximum per summary level and channel
+    T _max[TIERS > 0 ? TIERS : 1][CHANNELS][SLOTS];
+
+    /// Next row to be written per level
+    uint16_t _next[LEVELS];
+
+    /// Number of valid rows per level
+    uint16_t _rows[LEVELS];
+
+    /// Rows of the level below consolidated into one row of this summary level
+    uint16_t _factor[TIERS > 0 ? TIERS : 1];
+
+    /// Rows of the level below accumulated so far per summary level
+    uint16_t _pending[TIERS > 0 ? TIERS : 1];
+
+    /// Pending minimum per summary level and channel
+    T _acc_min[TIERS > 0 ? TIERS : 1][CHANNELS];
+
+    /// Pending maximum per summary level and channel
+    T _acc_max[TIERS > 0 ? TIERS : 1][CHANNELS];
+
+    /// Pending sum of means per summary level and channel
+    Sum _acc_sum[TIERS > 0 ? TIERS : 1][CHANNELS];
+
+    /// Period of the raw samples (ms)
+    uint32_t _period;
+
+    /// Time of the newest raw sample (ms)
+    uint32_t _newest_time;
+
+public:
+    // MARK: Const/Destructor (public)
+
+    /**
+     * @brief Constructor for the store.
+     *
+     * Every summary level consolidates 60 rows until `setup()` is called.
+     */
+    TimeSeriesStore() : _period(1000), _newest_time(0) {
+        for (int t = 0; t < TIERS; ++t) { _factor[t] = 60; }
+        clear();
+    }
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Setup the store.
+     *
+     * @param period Period of the raw samples (ms).
+     * @param factors `TIERS` consolidation factors, from the first summary level up.
+     */
+    void setup(const uint32_t period, const uint16_t* const factors) {
+        _period = period;
+        for (int t = 0; t < TIERS; ++t) { _factor[t] = factors[t] > 0 ? factors[t] : 1; }
+        clear();
+    }
+
+    /**
+     * @brief Discard all rows.
+     */
+    void clear() {
+        for (int l = 0; l < LEVELS; ++l) { _next[l] = _rows[l] = 0; }
+        for (int t = 0; t < TIERS; ++t) { _pending[t] = 0; }
+    }
+
+    /**
+     * @brief Append one sample of every channel.
+     *
+     * Completes and cascades summary rows as their factors are reached.
+     *
+     * @param values `CHANNELS` samples, in channel order.
+     * @param now Time of the samples (ms).
+     */
+    void append(const T* const values, const uint32_t now) {
+        const int row = _next[0];
+        for (int ch = 0; ch < CHANNELS; ++ch) { _raw[ch][row] = values[ch]; }
+        commit(0);
+        _newest_time = now;
+        for (int t = 0; t < TIERS; ++t) {
+            const int level = t + 1;
+            const bool first = _pending[t] == 0;
+            for (int ch = 0; ch < CHANNELS; ++ch) {
+                T lo, avg, hi;
+                if (t == 0) {
+                    lo = avg = hi = values[ch];
+                } else {
+                    const int below = (_next[t] + SLOTS - 1) % SLOTS;
+                    lo = _min[t - 1][ch][below];
+                    avg = _mean[t - 1][ch][below];
+                    hi = _max[t - 1][ch][below];
+                }
+                if (first or lo < _acc_min[t][ch]) { _acc_min[t][ch] = lo; }
+                if (first or hi > _acc_max[t][ch]) { _acc_max[t][ch] = hi; }
+                _acc_sum[t][ch] = (first ? Sum() : _acc_sum[t][ch]) + avg;
+            }
+            if (++_pending[t] < _factor[t]) { break; }
+            const int out = _next[level];
+            for (int ch = 0; ch < CHANNELS; ++ch) {
+                _min[t][ch][out] = _acc_min[t][ch];
+                _mean[t][ch][out] = static_cast<T>(_acc_sum[t][ch] / _factor[t]);
+                _max[t][ch][out] = _acc_max[t][ch];
+            }
+            _pending[t] = 0;
+            commit(level);
+        }
+    }
+
+    /**
+     * @brief Copy the newest rows of one channel at one level, oldest first.
+     *
+     * On the raw level, min, mean and max all receive the raw samples. Any output
+     * pointer may be `nullptr` to skip that column.
+     *
+     * @param channel Channel index.
+     * @param level Level (0: raw, 1..TIERS: summaries).
+     * @param count Maximum number of rows to copy.
+     * @param min Destination for row minima, or `nullptr`.
+     * @param mean Destination for row means, or `nullptr`.
+     * @param max Destination for row maxima, or `nullptr`.
+     * @return The number of rows copied.
+     */
+    int query(const int channel, const int level, int count, T* const min,
+              T* const mean, T* const max) const {
+        if (channel < 0 or channel >= CHANNELS or level < 0 or level >= LEVELS) {
+            return 0;
+        }
+        if (count < 0) { count = 0; }
+        if (count > _rows[level]) { count = _rows[level]; }
+        const T* lo = level == 0 ? _raw[channel] : _min[level - 1][channel];
+        const T* avg = level == 0 ? _raw[channel] : _mean[level - 1][channel];
+        const T* hi = level == 0 ? _raw[channel] : _max[level - 1][channel];
+        int src = (_next[level] + SLOTS - count) % SLOTS;
+        for (int i = 0; i < count; ++i) {
+            if (min) { min[i] = lo[src]; }
+            if (mean) { mean[i] = avg[src]; }
+            if (max) { max[i] = hi[src]; }
+            if (++src == SLOTS) { src = 0; }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Retrieves the number of valid rows at a level.
+     * @param level Level (0: raw, 1..TIERS: summaries).
+     * @return The row count, at most `SLOTS`.
+     */
+    inline int getRows(const int level) const { return _rows[level]; }
+
+    /**
+     * @brief Retrieves the time span of one row at a level.
+     * @param level Level (0: raw, 1..TIERS: summaries).
+     * @return The row period (ms).
+     */
+    uint32_t getRowPeriod(const int level) const {
+        uint32_t period = _period;
+        for (int t = 0; t < level and t < TIERS; ++t) { period *= _factor[t]; }
+        return period;
+    }
+
+    /**
+     * @brief Retrieves the time of the newest raw sample.
+     * @return The time passed to the last `append()` (ms).
+     */
+    inline uint32_t getNewestTime() const { return _newest_time; }
+
+    /**
+     * @brief Retrieves the rows of the level below accumulated toward the next row
+     * of a summary level.
+     * @param level Summary level (1..TIERS).
+     * @return The pending row count, less than the factor of the level.
+     */
+    inline int getPending(const int level) const { return _pending[level - 1]; }
+
+    /**
+     * @brief Retrieves when the newest row of a level ends.
+     *
+     * A row of `level` covers `getRowPeriod(level)` up to this time, and each older
+     * row one such period earlier; the samples after it are still pending.
+     *
+     * @param level Level (0: raw, 1..TIERS: summaries).
+     * @return The time of the newest raw sample in the newest row (ms); meaningless
+     *     while the level has no rows.
+     */
+    uint32_t getNewestRowTime(const int level) const {
+        uint32_t time = _newest_time;
+        for (int t = 0; t < level and t < TIERS; ++t) {
+            time -= _pending[t] * getRowPeriod(t);
+        }
+        return time;
+    }
+
+private:
+    // MARK: Specific utils (private)
+
+    /**
+     * @brief Advance the write position of a level after a row has been written.
+     * @param level Level whose row was written.
+     */
+    inline void commit(const int level) {
+        _next[level] = (_next[level] + 1) % SLOTS;
+        if (_rows[level] < SLOTS) { ++_rows[level]; }
+    }
+};
@@ -0,0 +1,92 @@
+// -*- coding:utf-8-unix -*-
+/**
+ * @file   Varint.hpp
+ * @brief  ZigZag and variable-length integer coding for compact sample records.
+ *
+ * @copyright
+ * (C) 2024 Mono Wireless Inc. All Rights Reserved.
+ * Released under MW-OSSLA-*J,*E (MONO WIRELESS OPEN SOURCE SOFTWARE LICENSE AGREEMENT).
+ */
+
+#pragma once
+
+/**
+ * @brief Header file dependency.
+ *
+ * Includes the MWX library, which provides the necessary interfaces for communication.
+ */
+#include <TWELITE>
+
+/**
+ * @class Varint
+ * @brief Little-endian base-128 coding of 32-bit integers.
+ *
+ * Small magnitudes take fewer bytes: deltas between neighbouring sensor samples
+ * usually fit in one or two bytes instead of four. Signed values are mapped with
+ * ZigZag coding first, so that small negative numbers stay small.
+ */
+class Varint {
+public:
+    // MARK: Constants (public)
+
+    /// Maximum number of bytes for an encoded 32-bit value
+    static const int MAX_LENGTH = 5;
+
+public:
+    // MARK: Interfaces (public)
+
+    /**
+     * @brief Map a signed value to an unsigned one (0, -1, 1, -2, ... to 0, 1, 2, 3).
+     * @param value The signed value.
+     * @return The ZigZag coded value.
+     */
+    static inline uint32_t zigzag(const int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    /**
+     * @brief Reverse the ZigZag mapping.
+     * @param value The ZigZag coded value.
+     * @return The signed value.
+     */
+    static inline int32_t unzigzag(const uint32_t value) {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    /**
+     * @brief Encode an unsigned value.
+     *
+     * @param value The value to encode.
+     * @param dst Destination buffer with room for at least `MAX_LENGTH` bytes.
+     * @return The number of bytes written.
+     */
+    static inline int encode(uint32_t value, uint8_t* const dst) {
+        int length = 0;
+        while (value >= 0x80) {
+            dst[length++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        dst[length++] = static_cast<uint8_t>(value);
+        return length;
+    }
+
+    /**
+     * @brief Decode an unsigned value.
+     *
+     * @param src Source buffer.
+     * @param size Number of readable bytes in `src`.
+     * @param value Pointer to store the decoded value.
+     * @return The number of bytes consumed, or `0` if the input is truncated.
+     */
+    static inline int decode(const uint8_t* const src, const int size, uint32_t* const value) {
+        uint32_t result = 0;
+        for (int i = 0; i < size and i < MAX_LENGTH; ++i) {
+            result |= static_cast<uint32_t>(src[i] & 0x7F) << (7 * i);
+            if ((src[i] & 0x80) == 0) {
+                *value = result;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+};